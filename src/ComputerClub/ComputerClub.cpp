@@ -1,71 +1,158 @@
 #include "ComputerClub.hpp"
 #include "Events.hpp"
+#include <algorithm>
 #include <cassert>
 
+namespace {
+/// Amount of tables above which free tables are searched without the set of free tables
+constexpr std::uintmax_t MaxFreeTablesAmount = std::uintmax_t{1} << 24;
+} // namespace
+
 namespace ComputerClub {
 
+template <IsEvent T, typename... Args> auto State::record(Args &&...args) -> void {
+  if (this->report.includes(T::Code)) {
+    this->events.emplace_back(std::make_unique<T>(std::forward<Args>(args)...));
+  }
+}
+
 template <> auto State::process(ClientArrivalEvent event) -> void {
   if (event.time < this->config.openingTime) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "NotOpenYet"));
+    this->record<ErrorEvent>(event.time, "NotOpenYet");
     return;
   }
-  if (this->clients.contains(event.client)) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "YouShallNotPass"));
+  auto [client, inserted] = this->clients.try_emplace(std::move(event.client));
+  if (!inserted) {
+    this->record<ErrorEvent>(event.time, "YouShallNotPass");
     return;
   }
 
-  this->clients[event.client] = {};
+  client->second.id = this->nextClientId++;
+  if (this->ledger != nullptr) {
+    this->ledger->clientNames.push_back(client->first);
+  }
+  if (this->trace != nullptr) {
+    this->trace->arrive(event.time, client->second.id, client->first);
+  }
 }
 
 template <> auto State::process(ClientSitInputEvent event) -> void {
-  if (!this->clients.contains(event.client)) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "ClientUnknown"));
+  auto client = this->clients.find(event.client);
+  if (client == this->clients.end()) {
+    this->record<ErrorEvent>(event.time, "ClientUnknown");
     return;
   }
-  if (this->tables.contains(event.table) && this->tables[event.table].currentStart.has_value()) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "PlaceIsBusy"));
+  if (auto table = this->tables.find(event.table);
+      table != this->tables.end() && table->second.currentStart.has_value()) {
+    this->record<ErrorEvent>(event.time, "PlaceIsBusy");
     return;
   }
 
-  this->clientSit(event.time, event.client, event.table);
+  this->clientSit(event.time, client->second, event.table);
 }
 
 template <> auto State::process(ClientWaitingEvent event) -> void {
-  if (!this->clients.contains(event.client)) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "ClientUnknown"));
+  auto client = this->clients.find(event.client);
+  if (client == this->clients.end()) {
+    this->record<ErrorEvent>(event.time, "ClientUnknown");
     return;
   }
-  ClientData &client = this->clients[event.client];
   if (this->usedTables < this->config.tablesAmount) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "ICanWaitNoLonger!"));
+    this->record<ErrorEvent>(event.time, "ICanWaitNoLonger!");
     return;
   }
   if (this->clientsQueue.size() >= this->config.tablesAmount) {
-    this->clients.erase(event.client);
-    this->events.emplace_back(
-        std::make_unique<ClientLeavingOutputEvent>(event.time, std::move(event.client)));
+    if (this->trace != nullptr) {
+      this->trace->depart(event.time, client->second.id);
+    }
+    this->clients.erase(client);
+    this->record<ClientLeavingOutputEvent>(event.time, std::move(event.client));
     return;
   }
 
-  if (!client.waiting) {
+  if (!client->second.waiting) {
+    if (this->trace != nullptr) {
+      this->trace->enqueue(event.time, client->second.id);
+    }
     this->clientsQueue.emplace(std::move(event.client));
-    client.waiting = true;
+    client->second.waiting = true;
   }
 }
 
 template <> auto State::process(ClientLeavingInputEvent event) -> void {
-  if (!this->clients.contains(event.client)) {
-    this->events.emplace_back(std::make_unique<ErrorEvent>(event.time, "ClientUnknown"));
+  auto client = this->clients.find(event.client);
+  if (client == this->clients.end()) {
+    this->record<ErrorEvent>(event.time, "ClientUnknown");
     return;
   }
 
-  this->tableLeave(event.time, this->clients.at(event.client).currentTable);
-  this->clients.erase(event.client);
+  this->tableLeave(event.time, client->second.currentTable);
+  if (this->trace != nullptr) {
+    this->trace->depart(event.time, client->second.id);
+  }
+  this->clients.erase(client);
 }
 
-auto State::clientSit(Time time, const std::string &client, std::uintmax_t table) -> void {
-  ClientData &clientData = this->clients.at(client);
+template <> auto State::process(ClientAutoSitInputEvent event) -> void {
+  auto client = this->clients.find(event.client);
+  if (client == this->clients.end()) {
+    this->record<ErrorEvent>(event.time, "ClientUnknown");
+    return;
+  }
+  // Tables out of range are counted as used but are not tracked by the free tables
+  auto table = this->usedTables < this->config.tablesAmount ? this->freeTable() : std::nullopt;
+  if (!table.has_value()) {
+    this->record<ErrorEvent>(event.time, "PlaceIsBusy");
+    return;
+  }
+
+  this->record<ClientSitOutputEvent>(event.time, std::move(event.client), table.value());
+  this->clientSit(event.time, client->second, table.value());
+}
+
+auto State::freeTable() -> std::optional<std::uintmax_t> {
+  if (this->config.tablesAmount > MaxFreeTablesAmount) {
+    // Set of free tables would not fit in memory. Only occupied tables are skipped, so at most
+    // one table more than the occupied ones is checked.
+    auto occupied = [this](std::uintmax_t table) {
+      auto tableIt = this->tables.find(table);
+      return tableIt != this->tables.end() && tableIt->second.currentStart.has_value();
+    };
+    if (this->config.seatPolicy == SeatPolicy::HighestNumber) {
+      for (std::uintmax_t table = this->config.tablesAmount; table >= 1; table--) {
+        if (!occupied(table)) {
+          return table;
+        }
+      }
+    } else {
+      for (std::uintmax_t table = 1; table <= this->config.tablesAmount; table++) {
+        if (!occupied(table)) {
+          return table;
+        }
+      }
+    }
+    return std::nullopt;
+  }
+
+  if (!this->freeTables.has_value()) {
+    this->freeTables.emplace(this->config.tablesAmount);
+    for (const auto &[table, data] : this->tables) {
+      if (data.currentStart.has_value()) {
+        this->freeTables->occupy(table);
+      }
+    }
+  }
+
+  switch (this->config.seatPolicy) {
+  case SeatPolicy::HighestNumber:
+    return this->freeTables->highest();
+  case SeatPolicy::LowestNumber:
+  default:
+    return this->freeTables->lowest();
+  }
+}
 
+auto State::clientSit(Time time, ClientData &clientData, std::uintmax_t table) -> void {
   if (clientData.currentTable != 0) {
     this->tableLeave(time, clientData.currentTable);
   }
@@ -73,46 +160,65 @@ auto State::clientSit(Time time, const std::string &client, std::uintmax_t table
   clientData.waiting = false;
 
   this->usedTables++;
-  if (!this->tables.contains(table)) {
-    this->tables[table] = {.currentStart = time};
-  } else {
-    this->tables[table].currentStart = time;
+  if (this->freeTables.has_value()) {
+    this->freeTables->occupy(table);
+  }
+  TableData &tableData = this->tables[table];
+  tableData.currentStart = time;
+  tableData.currentClient = clientData.id;
+  if (this->trace != nullptr) {
+    this->trace->seat(time, clientData.id, table);
   }
 }
 
 auto State::tableLeave(Time time, std::uintmax_t table) -> void {
-  if (!this->tables.contains(table)) {
-    return;
-  }
-
-  TableData &tableData = this->tables[table];
-
-  if (!tableData.currentStart.has_value()) {
+  auto tableIt = this->tables.find(table);
+  if (tableIt == this->tables.end() || !tableIt->second.currentStart.has_value()) {
     return;
   }
+  TableData &tableData = tableIt->second;
 
   Time diff = time - tableData.currentStart.value();
   tableData.usedTime += diff;
   std::uintmax_t hoursSpent = diff.minute == 0 ? diff.hour : diff.hour + 1;
-  tableData.revenue += hoursSpent * this->config.costPerHour;
+  std::uintmax_t charge = hoursSpent * this->config.costPerHour;
+  tableData.revenue += charge;
+  if (this->ledger != nullptr) {
+    this->ledger->sessions.push_back({
+        .client = tableData.currentClient,
+        .start = tableData.currentStart.value(),
+        .end = time,
+        .table = table,
+        .charge = charge,
+    });
+  }
   tableData.currentStart = std::nullopt;
+  if (this->trace != nullptr) {
+    this->trace->revenue(time, table, hoursSpent, charge);
+    this->trace->leave(time, tableData.currentClient, table);
+  }
 
+  if (this->freeTables.has_value()) {
+    this->freeTables->release(table);
+  }
   if (this->clientsQueue.empty()) {
     this->usedTables--;
   } else {
     std::string client = this->clientsQueue.front();
-    this->events.emplace_back(std::make_unique<ClientSitOutputEvent>(time, client, table));
+    this->record<ClientSitOutputEvent>(time, client, table);
     this->clientsQueue.pop();
-    this->clientSit(time, client, table);
+    ClientData &clientData = this->clients.at(client);
+    if (this->trace != nullptr) {
+      this->trace->dequeue(time, clientData.id);
+    }
+    this->clientSit(time, clientData, table);
   }
 }
 
 auto State::processEvent(InputEvent event) -> void {
-  auto eventToPtr = [](auto event) -> std::unique_ptr<Event> {
-    return std::make_unique<decltype(event)>(std::move(event));
-  };
-
-  this->events.emplace_back(std::visit(eventToPtr, event));
+  std::visit(
+      [this](const auto &event) { this->record<std::remove_cvref_t<decltype(event)>>(event); },
+      event);
 
   std::visit([this](const auto &event) { return this->process(event); }, std::move(event));
 }
@@ -123,25 +229,41 @@ auto State::endDay() -> void {
   this->clientsQueue = {};
   for (auto &&[client, data] : std::move(this->clients)) {
     this->tableLeave(time, data.currentTable);
-    this->events.emplace_back(std::make_unique<ClientLeavingOutputEvent>(time, std::move(client)));
+    if (this->trace != nullptr) {
+      this->trace->depart(time, data.id);
+    }
+    this->record<ClientLeavingOutputEvent>(time, std::move(client));
   }
   this->clients = {};
 }
 
-auto State::print(std::ostream &stream) -> void {
-  stream << this->config.openingTime << '\n';
-  for (const auto &event : this->events) {
-    event->print(stream);
-    stream << '\n';
+auto State::print(std::ostream &stream) const -> void {
+  if (this->report.openingTime) {
+    stream << this->config.openingTime << '\n';
   }
-  stream << this->config.closingTime << '\n';
-  for (std::uintmax_t i = 1; i <= this->config.tablesAmount; i++) {
-    if (this->tables.contains(i)) {
-      stream << i << ' ' << this->tables[i].revenue << ' ' << this->tables[i].usedTime << '\n';
-    } else {
-      stream << i << " 0 00:00\n";
-    }
+  this->printEvents(stream, 0, this->events.size());
+  if (this->report.closingTime) {
+    stream << this->config.closingTime << '\n';
+  }
+  if (this->report.tables) {
+    this->printTables(stream);
   }
 }
 
+auto State::printEvents(std::ostream &stream, std::size_t first, std::size_t last,
+                        std::string_view prefix) const -> void {
+  for (std::size_t i = first; i < last; i++) {
+    stream << prefix;
+    this->events[i]->print(stream);
+    stream << '\n';
+  }
+}
+
+auto State::printTables(std::ostream &stream, std::string_view prefix) const -> void {
+  this->forEachTable(
+      [&stream, prefix](std::uintmax_t table, std::uintmax_t revenue, Time usedTime) {
+        stream << prefix << table << ' ' << revenue << ' ' << usedTime << '\n';
+      });
+}
+
 } // namespace ComputerClub
@@ -2,21 +2,48 @@
 
 #include "Config.hpp"
 #include "Events.hpp"
+#include "FreeTables.hpp"
+#include "Report.hpp"
+#include "Trace.hpp"
 #include <map>
 #include <memory>
 #include <optional>
 #include <queue>
+#include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
 
 namespace ComputerClub {
 
+/// Session of the client at the table
+struct Session {
+  std::uint32_t client;  ///< Id of the client
+  Time start;            ///< Time client sat at the table
+  Time end;              ///< Time client left the table
+  std::uintmax_t table;  ///< Table number
+  std::uintmax_t charge; ///< Charge for the session
+};
+
+/// Finished sessions of the clients of the day
+struct Ledger {
+  std::vector<std::string> clientNames = {}; ///< Names of the clients arrived during the day by id
+  std::vector<Session> sessions = {};        ///< Sessions in the order they ended
+};
+
 /// State of the computer club
 class State {
 public:
   /// Creates a new computer club
   /// @param config configuration of the club
-  explicit State(Config config) : config(config) {}
+  /// @param report sections and events that will be printed. Events that are not printed are not
+  ///        recorded.
+  /// @param trace    writer of state transitions, nullptr if transitions are not traced
+  /// @param ledger   finished sessions and names of the clients are appended to it, nullptr if
+  ///        sessions are not recorded
+  explicit State(Config config, Report report = {}, Trace::Writer *trace = nullptr,
+                 Ledger *ledger = nullptr)
+      : config(config), report(report), trace(trace), ledger(ledger) {}
 
   /// Processes the event
   /// @param event event to process. Event time should be greater or equal to the time of the last
@@ -30,27 +57,31 @@ public:
   /// Prints all events and the end of the day each on it's own line.
   /// Prints closing time of the computer club.
   /// Prints revenue of all tables and time spent at table in the club each on it's own line.
-  auto print(std::ostream &stream) -> void;
-
-private:
-  /// Processes the event
-  /// @tparam T type of the event to process
-  /// @param event event to process
-  template <IsInputEvent T> auto process(T event) -> void = delete;
-
-  /// Processes client leaving table. Calculates client's time spent at the table and revenue.
-  /// If there are clients waiting in the queue, the first one is seated at the table.
-  /// @param time time of the event
-  /// @param table table number
-  auto tableLeave(Time time, std::uintmax_t table) -> void;
-
-  /// Processes client sitting at the table. If client is currently sitting at other table, he is
-  /// leaving previous table and moving to the new one.
-  /// Caller should check whether @p table is occupied or not
-  /// @param time time of the event
-  /// @param client client name
-  /// @param table table number
-  auto clientSit(Time time, const std::string &client, std::uintmax_t table) -> void;
+  /// Only sections and events selected by the report of the club are printed.
+  auto print(std::ostream &stream) const -> void;
+
+  /// @returns number of events recorded so far
+  auto recordedEvents() const -> std::size_t { return this->events.size(); }
+
+  /// Prints recorded events with indices in [@p first, @p last) each on it's own line
+  /// @param prefix string printed at the start of each line
+  auto printEvents(std::ostream &stream, std::size_t first, std::size_t last,
+                   std::string_view prefix = {}) const -> void;
+
+  /// Prints revenue of all tables and time spent at table in the club each on it's own line
+  /// @param prefix string printed at the start of each line
+  auto printTables(std::ostream &stream, std::string_view prefix = {}) const -> void;
+
+  /// Calls @p callback with number, revenue and time spent of each table of the club
+  template <typename F> auto forEachTable(F callback) const -> void {
+    for (std::uintmax_t i = 1; i <= this->config.tablesAmount; i++) {
+      if (auto table = this->tables.find(i); table != this->tables.end()) {
+        callback(i, table->second.revenue, table->second.usedTime);
+      } else {
+        callback(i, std::uintmax_t{0}, Time{0, 0});
+      }
+    }
+  }
 
 private:
   /// Data of the table
@@ -63,31 +94,80 @@ private:
 
     /// Total time spent at the table
     Time usedTime = {.hour = 0, .minute = 0};
+
+    /// Id of the current client at the table
+    std::uint32_t currentClient = 0;
   };
 
   /// Data of the client
   struct ClientData {
     std::uintmax_t currentTable = 0; ///< Table client sitting at. 0 if client is not sitting.
     bool waiting = false;            ///< Whether client is waiting in the queue.
+    std::uint32_t id = 0;            ///< Id of the client, unique during the day.
   };
 
+private:
+  /// Processes the event
+  /// @tparam T type of the event to process
+  /// @param event event to process
+  template <IsInputEvent T> auto process(T event) -> void = delete;
+
+  /// Records the event if it is selected by the report
+  /// @tparam T type of the event to record
+  /// @param args arguments of the event constructor
+  template <IsEvent T, typename... Args> auto record(Args &&...args) -> void;
+
+  /// Processes client leaving table. Calculates client's time spent at the table and revenue.
+  /// If there are clients waiting in the queue, the first one is seated at the table.
+  /// @param time time of the event
+  /// @param table table number
+  auto tableLeave(Time time, std::uintmax_t table) -> void;
+
+  /// Builds the set of free tables on the first call
+  /// @returns free table chosen by the seat policy of the club, @c std::nullopt if all tables are
+  ///          occupied
+  auto freeTable() -> std::optional<std::uintmax_t>;
+
+  /// Processes client sitting at the table. If client is currently sitting at other table, he is
+  /// leaving previous table and moving to the new one.
+  /// Caller should check whether @p table is occupied or not
+  /// @param time time of the event
+  /// @param clientData data of the client
+  /// @param table table number
+  auto clientSit(Time time, ClientData &clientData, std::uintmax_t table) -> void;
+
 private:
   /// Configuration of the club
   Config config;
 
+  /// Sections and events to print
+  Report report;
+
+  /// Writer of state transitions, nullptr if transitions are not traced
+  Trace::Writer *trace;
+
+  /// Finished sessions of the clients, nullptr if sessions are not recorded
+  Ledger *ledger;
+
   /// Data of the tables
   std::unordered_map<std::uintmax_t, TableData> tables = {};
 
   /// Number of used tables
   std::uintmax_t usedTables = 0;
 
+  /// Free tables of the club, built only when a client is seated automatically
+  std::optional<FreeTables> freeTables = std::nullopt;
+
   /// Data of the clients
   std::map<std::string, ClientData> clients = {};
 
+  /// Id of the next arriving client
+  std::uint32_t nextClientId = 0;
+
   /// Queue of clients waiting for a table
   std::queue<std::string> clientsQueue = {};
 
-  /// List of events happened in the club
+  /// List of events happened in the club and selected by the report
   std::vector<std::unique_ptr<Event>> events = {};
 };
 
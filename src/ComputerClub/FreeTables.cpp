@@ -0,0 +1,75 @@
+#include "FreeTables.hpp"
+#include <bit>
+
+namespace {
+constexpr std::size_t WordBits = 64;
+} // namespace
+
+namespace ComputerClub {
+
+FreeTables::FreeTables(std::uint64_t tablesAmount) : tablesAmount(tablesAmount) {
+  std::uint64_t bits = tablesAmount;
+  do {
+    std::vector<std::uint64_t> level((bits + WordBits - 1) / WordBits, ~std::uint64_t{0});
+    if (bits % WordBits != 0) {
+      level.back() = (std::uint64_t{1} << (bits % WordBits)) - 1;
+    }
+    bits = level.size();
+    this->levels.push_back(std::move(level));
+  } while (bits > 1);
+}
+
+auto FreeTables::occupy(std::uintmax_t table) -> void {
+  if (table == 0 || table > this->tablesAmount) {
+    return;
+  }
+  std::uintmax_t bit = table - 1;
+  for (auto &level : this->levels) {
+    std::uint64_t &word = level[bit / WordBits];
+    word &= ~(std::uint64_t{1} << (bit % WordBits));
+    if (word != 0) {
+      return;
+    }
+    bit /= WordBits;
+  }
+}
+
+auto FreeTables::release(std::uintmax_t table) -> void {
+  if (table == 0 || table > this->tablesAmount) {
+    return;
+  }
+  std::uintmax_t bit = table - 1;
+  for (auto &level : this->levels) {
+    std::uint64_t &word = level[bit / WordBits];
+    bool wasEmpty = word == 0;
+    word |= std::uint64_t{1} << (bit % WordBits);
+    if (!wasEmpty) {
+      return;
+    }
+    bit /= WordBits;
+  }
+}
+
+auto FreeTables::lowest() const -> std::optional<std::uintmax_t> {
+  if (this->levels.back().empty() || this->levels.back().front() == 0) {
+    return std::nullopt;
+  }
+  std::uintmax_t index = 0;
+  for (auto level = this->levels.rbegin(); level != this->levels.rend(); level++) {
+    index = index * WordBits + std::countr_zero((*level)[index]);
+  }
+  return index + 1;
+}
+
+auto FreeTables::highest() const -> std::optional<std::uintmax_t> {
+  if (this->levels.back().empty() || this->levels.back().front() == 0) {
+    return std::nullopt;
+  }
+  std::uintmax_t index = 0;
+  for (auto level = this->levels.rbegin(); level != this->levels.rend(); level++) {
+    index = index * WordBits + (WordBits - 1 - std::countl_zero((*level)[index]));
+  }
+  return index + 1;
+}
+
+} // namespace ComputerClub
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace ComputerClub {
+
+/// Set of free tables of the club. Each table is a bit of the bottom level, each bit of the upper
+/// level tells whether corresponding word of the level below has any free table. Finding the
+/// lowest or the highest free table takes one word per level.
+class FreeTables {
+public:
+  /// Creates a set where all tables are free
+  /// @param tablesAmount amount of tables, tables are numbered from 1
+  explicit FreeTables(std::uint64_t tablesAmount);
+
+  /// Marks @p table as occupied. Tables out of range are ignored.
+  auto occupy(std::uintmax_t table) -> void;
+
+  /// Marks @p table as free. Tables out of range are ignored.
+  auto release(std::uintmax_t table) -> void;
+
+  /// @returns the lowest-numbered free table, @c std::nullopt if all tables are occupied
+  auto lowest() const -> std::optional<std::uintmax_t>;
+
+  /// @returns the highest-numbered free table, @c std::nullopt if all tables are occupied
+  auto highest() const -> std::optional<std::uintmax_t>;
+
+private:
+  /// Words of each level, from the bottom one with a bit per table to the top one with one word
+  std::vector<std::vector<std::uint64_t>> levels = {};
+
+  /// Amount of tables
+  std::uint64_t tablesAmount;
+};
+
+} // namespace ComputerClub
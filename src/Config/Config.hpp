@@ -2,15 +2,47 @@
 
 #include "Time.hpp"
 #include <cstdint>
+#include <vector>
 
 namespace ComputerClub {
 
+/// Partition of the computer club with its own tables, queue and pricing
+struct Zone {
+  std::uint64_t tablesAmount; ///< Amount of tables in the zone
+  std::uint64_t costPerHour;  ///< Cost per hour of using the table in the zone
+};
+
+/// Policy of choosing a free table for the client that did not name one
+enum class SeatPolicy {
+  LowestNumber,  ///< The free table with the lowest number is chosen
+  HighestNumber, ///< The free table with the highest number is chosen
+};
+
 /// Configuration of computer club
 struct Config {
   std::uint64_t tablesAmount; ///< Amount of tables in the club
   Time openingTime;           ///< Time when the club opens
   Time closingTime;           ///< Time when the club closes, should be greater than opening time
   std::uint64_t costPerHour;  ///< Cost per hour of using the table
+
+  /// Zones the club is partitioned into. Empty if the club is not partitioned. Otherwise
+  /// @c tablesAmount is the total amount of tables and @c costPerHour is not used.
+  std::vector<Zone> zones = {};
+
+  /// Policy of choosing a free table for the client that did not name one
+  SeatPolicy seatPolicy = SeatPolicy::LowestNumber;
+
+  /// Configuration of the zone as of the separate club
+  /// @param zone index of the zone in @c zones
+  auto zoneConfig(std::size_t zone) const -> Config {
+    return {
+        .tablesAmount = this->zones[zone].tablesAmount,
+        .openingTime = this->openingTime,
+        .closingTime = this->closingTime,
+        .costPerHour = this->zones[zone].costPerHour,
+        .seatPolicy = this->seatPolicy,
+    };
+  }
 };
 
 } // namespace ComputerClub
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <bitset>
+#include <cstdint>
+
+namespace ComputerClub {
+
+/// Selection of the sections and events rendered in the report of the day
+struct Report {
+  /// Largest code of the event that can appear in the report
+  static constexpr std::size_t MaxEventCode = 13;
+
+  bool openingTime = true; ///< Whether to print opening time of the club
+  bool events = true;      ///< Whether to print events happened in the club
+  bool closingTime = true; ///< Whether to print closing time of the club
+  bool tables = true;      ///< Whether to print revenue and time spent at each table
+
+  /// Codes of the events to print. Events with other codes are not recorded at all.
+  std::bitset<MaxEventCode + 1> eventCodes = std::bitset<MaxEventCode + 1>().set();
+
+  /// @returns whether events with @p code are printed
+  auto includes(std::uint8_t code) const -> bool {
+    return this->events && code <= MaxEventCode && this->eventCodes.test(code);
+  }
+};
+
+} // namespace ComputerClub
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <concepts>
+#include <cstdint>
 #include <ostream>
 #include <variant>
 
@@ -39,6 +40,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 1;
+
   /// Create a new client arrival event.
   /// @param time   Time of the event.
   /// @param client Name of the client.
@@ -55,6 +59,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 2;
+
   /// Create a new client sit event.
   /// @param time   Time of the event.
   /// @param client Name of the client.
@@ -74,6 +81,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 3;
+
   /// Create a new client waiting event.
   /// @param time   Time of the event.
   /// @param client Name of the client.
@@ -90,6 +100,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 4;
+
   /// Create a new client leaving event.
   /// @param time   Time of the event.
   /// @param client Name of the client.
@@ -100,16 +113,36 @@ public:
   std::string client; ///< Name of the client.
 };
 
+/// Event representing client sitting at any free table.
+class ClientAutoSitInputEvent final : public Event {
+public:
+  /// @copydoc Event::print
+  auto print(std::ostream &stream) const -> void override;
+
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 5;
+
+  /// Create a new client auto sit event.
+  /// @param time   Time of the event.
+  /// @param client Name of the client.
+  ClientAutoSitInputEvent(Time time, std::string client) : time(time), client(std::move(client)) {}
+
+public:
+  Time time;          ///< Time of the event.
+  std::string client; ///< Name of the client.
+};
+
 /// Input event that can happen in the club.
 using InputEvent = std::variant<ClientArrivalEvent, ClientSitInputEvent, ClientWaitingEvent,
-                                ClientLeavingInputEvent>;
+                                ClientLeavingInputEvent, ClientAutoSitInputEvent>;
 
 /// Concept that checks if the type is an input event.
 /// @tparam T Type to check.
 template <typename T>
 concept IsInputEvent =
     std::is_same_v<T, ClientArrivalEvent> || std::is_same_v<T, ClientSitInputEvent> ||
-    std::is_same_v<T, ClientWaitingEvent> || std::is_same_v<T, ClientLeavingInputEvent>;
+    std::is_same_v<T, ClientWaitingEvent> || std::is_same_v<T, ClientLeavingInputEvent> ||
+    std::is_same_v<T, ClientAutoSitInputEvent>;
 
 /// Event representing client leaving the club.
 class ClientLeavingOutputEvent final : public Event {
@@ -117,6 +150,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 11;
+
   /// Create a new client leaving event.
   /// @param time   Time of the event.
   /// @param client Name of the client.
@@ -133,6 +169,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 12;
+
   /// Create a new client sit event.
   /// @param time   Time of the event.
   /// @param client Name of the client.
@@ -152,6 +191,9 @@ public:
   /// @copydoc Event::print
   auto print(std::ostream &stream) const -> void override;
 
+  /// Code of the event.
+  static constexpr std::uint8_t Code = 13;
+
   /// Create a new error event.
   /// @param time    Time of the event.
   /// @param message Error message.
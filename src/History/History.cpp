@@ -0,0 +1,306 @@
+#include "History.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+#include <unordered_map>
+
+namespace {
+
+/// Magic bytes at the start of the history file
+constexpr char Magic[4] = {'C', 'C', 'H', '2'};
+
+/// Sentinel bytes at the end of each block
+constexpr char BlockEnd[4] = {'C', 'C', 'H', 'E'};
+
+/// Size of the block trailer: size of the block data, checksum and sentinel
+constexpr std::size_t TrailerSize = 2 * sizeof(std::uint32_t) + sizeof(BlockEnd);
+
+/// FNV-1a hash of @p size bytes at @p data
+auto checksum(const char *data, std::size_t size) -> std::uint32_t {
+  std::uint32_t hash = 2166136261u;
+  for (std::size_t i = 0; i < size; i++) {
+    hash = (hash ^ std::uint8_t(data[i])) * 16777619u;
+  }
+  return hash;
+}
+
+/// Checks the trailer of the block whose data is @p size bytes at @p data
+/// @param trailer trailer of the block, @ref TrailerSize bytes
+auto validBlock(const char *data, std::size_t size, const char *trailer) -> bool {
+  std::uint32_t blockSize;
+  std::uint32_t blockChecksum;
+  std::memcpy(&blockSize, trailer, sizeof(blockSize));
+  std::memcpy(&blockChecksum, trailer + sizeof(blockSize), sizeof(blockChecksum));
+  return blockSize == size && blockChecksum == checksum(data, size) &&
+         std::equal(std::begin(BlockEnd), std::end(BlockEnd), trailer + 2 * sizeof(std::uint32_t));
+}
+
+/// Checks that the history file @p file of @p size bytes ends with a complete block. Only the last
+/// block is read.
+auto validTail(std::istream &file, std::uintmax_t size) -> bool {
+  if (size == sizeof(Magic)) {
+    return true;
+  }
+  if (size < sizeof(Magic) + TrailerSize) {
+    return false;
+  }
+  char trailer[TrailerSize];
+  file.seekg(std::streamoff(size - TrailerSize));
+  if (!file.read(trailer, TrailerSize)) {
+    return false;
+  }
+  std::uint32_t blockSize;
+  std::memcpy(&blockSize, trailer, sizeof(blockSize));
+  if (blockSize > size - sizeof(Magic) - TrailerSize) {
+    return false;
+  }
+  std::vector<char> block(blockSize);
+  file.seekg(std::streamoff(size - TrailerSize - blockSize));
+  return file.read(block.data(), blockSize) && validBlock(block.data(), blockSize, trailer);
+}
+
+auto tryParseDigits(std::string_view str) -> std::optional<std::uint32_t> {
+  std::uint32_t result = 0;
+  for (char c : str) {
+    if (c < '0' || c > '9') {
+      return std::nullopt;
+    }
+    result = result * 10 + (c - '0');
+  }
+  return result;
+}
+
+auto daysInMonth(std::uint32_t year, std::uint32_t month) -> std::uint32_t {
+  if (month == 2) {
+    bool leap = year % 4 == 0 && (year % 100 != 0 || year % 400 == 0);
+    return leap ? 29 : 28;
+  }
+  return month == 4 || month == 6 || month == 9 || month == 11 ? 30 : 31;
+}
+
+/// Reads the value of type @p T from @p data at @p offset, advances @p offset
+template <typename T>
+auto read(const std::vector<char> &data, std::size_t &offset, T &value) -> bool {
+  if (data.size() - offset < sizeof(T)) {
+    return false;
+  }
+  std::memcpy(&value, data.data() + offset, sizeof(T));
+  offset += sizeof(T);
+  return true;
+}
+
+/// Reads @p amount values of type @p T from @p data at @p offset, advances @p offset
+template <typename T>
+auto readColumn(const std::vector<char> &data, std::size_t &offset, std::size_t amount,
+                std::vector<T> &column) -> bool {
+  if ((data.size() - offset) / sizeof(T) < amount) {
+    return false;
+  }
+  column.resize(amount);
+  std::memcpy(column.data(), data.data() + offset, amount * sizeof(T));
+  offset += amount * sizeof(T);
+  return true;
+}
+
+template <typename T> auto write(std::vector<char> &data, const T &value) -> void {
+  auto bytes = reinterpret_cast<const char *>(&value);
+  data.insert(data.end(), bytes, bytes + sizeof(T));
+}
+
+template <typename T>
+auto writeColumn(std::vector<char> &data, const std::vector<T> &column) -> void {
+  auto bytes = reinterpret_cast<const char *>(column.data());
+  data.insert(data.end(), bytes, bytes + column.size() * sizeof(T));
+}
+
+} // namespace
+
+namespace ComputerClub::History {
+
+auto parseDate(std::string_view str) -> std::optional<Date> {
+  if (str.size() != 10 || str[7] != '-') {
+    return std::nullopt;
+  }
+  auto month = parseMonth(str.substr(0, 7));
+  auto day = tryParseDigits(str.substr(8, 2));
+  if (!month.has_value() || !day.has_value() || day.value() < 1 ||
+      day.value() > daysInMonth(month->first / 10000, month->first / 100 % 100)) {
+    return std::nullopt;
+  }
+  return month->first + day.value();
+}
+
+auto parseMonth(std::string_view str) -> std::optional<std::pair<Date, Date>> {
+  if (str.size() != 7 || str[4] != '-') {
+    return std::nullopt;
+  }
+  auto year = tryParseDigits(str.substr(0, 4));
+  auto month = tryParseDigits(str.substr(5, 2));
+  if (!year.has_value() || !month.has_value() || month.value() < 1 || month.value() > 12) {
+    return std::nullopt;
+  }
+  Date first = year.value() * 10000 + month.value() * 100;
+  return std::pair{first, first + 99};
+}
+
+auto append(const std::filesystem::path &path, const Day &day) -> void {
+  if (day.usedMinutes.size() != day.revenue.size()) {
+    throw HistoryError("Columns of the day " + std::to_string(day.date) + " differ in length");
+  }
+
+  std::error_code error;
+  auto size = std::filesystem::file_size(path, error);
+  bool empty = error || size == 0;
+  if (!empty) {
+    std::ifstream file(path, std::ios::binary);
+    char magic[sizeof(Magic)];
+    if (!file.read(magic, sizeof(magic)) ||
+        !std::equal(std::begin(Magic), std::end(Magic), std::begin(magic))) {
+      throw HistoryError(path.string() + " is not a history file");
+    }
+    if (!validTail(file, size)) {
+      throw HistoryError(path.string() + " ends with a torn block, repair it first");
+    }
+  }
+
+  std::vector<char> block;
+  if (empty) {
+    block.insert(block.end(), std::begin(Magic), std::end(Magic));
+  }
+  std::size_t start = block.size();
+  write(block, day.date);
+  write(block, day.openMinutes);
+  write(block, std::uint32_t(day.revenue.size()));
+  writeColumn(block, day.revenue);
+  writeColumn(block, day.usedMinutes);
+  auto blockSize = std::uint32_t(block.size() - start);
+  write(block, blockSize);
+  write(block, checksum(block.data() + start, blockSize));
+  block.insert(block.end(), std::begin(BlockEnd), std::end(BlockEnd));
+
+  std::ofstream file(path, std::ios::binary | std::ios::app);
+  if (!file.is_open()) {
+    throw HistoryError("Failed to open " + path.string());
+  }
+  if (!file.write(block.data(), std::streamsize(block.size())) || !file.flush()) {
+    throw HistoryError("Failed to write " + path.string());
+  }
+}
+
+Store::Store(const std::filesystem::path &path) {
+  std::ifstream file(path, std::ios::binary);
+  if (!file.is_open()) {
+    return;
+  }
+  std::vector<char> data(std::istreambuf_iterator<char>(file), {});
+  if (data.empty()) {
+    return;
+  }
+  if (data.size() < sizeof(Magic) ||
+      !std::equal(std::begin(Magic), std::end(Magic), data.begin())) {
+    throw HistoryError(path.string() + " is not a history file");
+  }
+
+  // Index of each date in daysData, a day appended again replaces the earlier one
+  std::unordered_map<Date, std::size_t> dayIndices;
+  std::size_t offset = sizeof(Magic);
+  while (offset < data.size()) {
+    std::size_t start = offset;
+    Day day;
+    std::uint32_t tablesAmount;
+    if (!read(data, offset, day.date) || !read(data, offset, day.openMinutes) ||
+        !read(data, offset, tablesAmount) ||
+        !readColumn(data, offset, tablesAmount, day.revenue) ||
+        !readColumn(data, offset, tablesAmount, day.usedMinutes) ||
+        data.size() - offset < TrailerSize ||
+        !validBlock(data.data() + start, offset - start, data.data() + offset)) {
+      // Block torn by a crash during append, following data can not be trusted
+      this->validSize = start;
+      break;
+    }
+    offset += TrailerSize;
+
+    auto [index, inserted] = dayIndices.try_emplace(day.date, this->daysData.size());
+    if (inserted) {
+      this->daysData.push_back(std::move(day));
+    } else {
+      this->daysData[index->second] = std::move(day);
+    }
+  }
+}
+
+auto Store::repair(const std::filesystem::path &path) -> bool {
+  Store store(path);
+  if (!store.tornTail()) {
+    return false;
+  }
+  std::error_code error;
+  std::filesystem::resize_file(path, store.validSize.value(), error);
+  if (error) {
+    throw HistoryError("Failed to repair " + path.string());
+  }
+  return true;
+}
+
+auto Store::revenue(Date from, Date to) const -> std::vector<std::uint64_t> {
+  std::vector<std::uint64_t> result;
+  for (const Day &day : this->daysData) {
+    if (day.date < from || day.date > to) {
+      continue;
+    }
+    if (result.size() < day.revenue.size()) {
+      result.resize(day.revenue.size());
+    }
+    const std::uint64_t *revenue = day.revenue.data();
+    std::uint64_t *sum = result.data();
+    for (std::size_t i = 0; i < day.revenue.size(); i++) {
+      sum[i] += revenue[i];
+    }
+  }
+  return result;
+}
+
+auto Store::utilization(Date from, Date to, double percentile) const -> std::vector<double> {
+  std::size_t tablesAmount = 0;
+  std::size_t daysAmount = 0;
+  for (const Day &day : this->daysData) {
+    if (day.date >= from && day.date <= to) {
+      tablesAmount = std::max(tablesAmount, day.usedMinutes.size());
+      daysAmount++;
+    }
+  }
+  if (daysAmount == 0) {
+    return {};
+  }
+
+  // Utilization of each table on each day, stored by table
+  std::vector<double> values(tablesAmount * daysAmount, 0.0);
+  std::size_t dayIndex = 0;
+  for (const Day &day : this->daysData) {
+    if (day.date < from || day.date > to) {
+      continue;
+    }
+    if (day.openMinutes != 0) {
+      double scale = 1.0 / day.openMinutes;
+      for (std::size_t i = 0; i < day.usedMinutes.size(); i++) {
+        values[i * daysAmount + dayIndex] = day.usedMinutes[i] * scale;
+      }
+    }
+    dayIndex++;
+  }
+
+  auto rank = std::size_t(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * daysAmount));
+  rank = rank == 0 ? 0 : rank - 1;
+  std::vector<double> result(tablesAmount);
+  for (std::size_t i = 0; i < tablesAmount; i++) {
+    auto begin = values.begin() + std::ptrdiff_t(i * daysAmount);
+    std::nth_element(begin, begin + std::ptrdiff_t(rank), begin + std::ptrdiff_t(daysAmount));
+    result[i] = begin[std::ptrdiff_t(rank)];
+  }
+  return result;
+}
+
+} // namespace ComputerClub::History
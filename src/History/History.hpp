@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace ComputerClub::History {
+
+/// Date of the day in format YYYYMMDD, e.g. 20240131 for the 31st of January 2024
+using Date = std::uint32_t;
+
+/// Parse the date in format "YYYY-MM-DD", day of the month is checked against the length of the
+/// month.
+/// @returns @c std::nullopt if @p str is not a valid date.
+auto parseDate(std::string_view str) -> std::optional<Date>;
+
+/// Parse the month in format "YYYY-MM".
+/// @returns first and last possible dates of the month, @c std::nullopt if @p str is not valid.
+auto parseMonth(std::string_view str) -> std::optional<std::pair<Date, Date>>;
+
+/// Exception thrown when the history file can not be read or written.
+class HistoryError final : public std::runtime_error {
+public:
+  HistoryError(const std::string &message) : runtime_error(message) {}
+};
+
+/// Per-table results of one day of the club
+struct Day {
+  Date date = 0;                               ///< Date of the day
+  std::uint32_t openMinutes = 0;               ///< Minutes the club was open
+  std::vector<std::uint64_t> revenue = {};     ///< Revenue of each table, starting from table 1
+  std::vector<std::uint32_t> usedMinutes = {}; ///< Minutes each table was used
+};
+
+/// Appends results of the @p day to the store file at @p path. Only the last block of the file is
+/// read to check it is complete. Missing or empty file is started with the header.
+/// @throws HistoryError If columns of the @p day differ in length, the file ends with a torn block
+///         or it can not be written.
+auto append(const std::filesystem::path &path, const Day &day) -> void;
+
+/// Append-only columnar store of per-table results of the club, one file per club.
+/// The file consists of blocks, one per day. Each block holds the date, minutes the club was open,
+/// amount of tables, then revenue column and used minutes column. The block ends with a trailer of
+/// its size, checksum and sentinel, so a block torn by a crash is detected. Values are stored in
+/// the native byte order. A day appended again replaces the earlier results of the same date.
+class Store {
+public:
+  /// Loads the store from @p path for queries. Missing file is treated as empty store. Torn block
+  /// at the end of the file is ignored, days before it are loaded.
+  /// @throws HistoryError If the file is not a history file.
+  explicit Store(const std::filesystem::path &path);
+
+  /// Truncates the torn block at the end of the store file at @p path
+  /// @returns @c true if the file had a torn block
+  /// @throws HistoryError If the file is not a history file or can not be truncated.
+  static auto repair(const std::filesystem::path &path) -> bool;
+
+  /// @returns Days of the store in the order they were first appended
+  auto days() const -> const std::vector<Day> & { return this->daysData; }
+
+  /// @returns @c true if the file ends with a torn block, e.g. after a crash during append
+  auto tornTail() const -> bool { return this->validSize.has_value(); }
+
+  /// Sums revenue of each table over the days in [@p from, @p to].
+  /// @returns Revenue of each table starting from table 1
+  auto revenue(Date from, Date to) const -> std::vector<std::uint64_t>;
+
+  /// Computes the percentile of daily utilization of each table over the days in [@p from, @p to].
+  /// Utilization is the fraction of the opening hours the table was used. Days when the club had
+  /// fewer tables are counted as zero utilization of the missing tables.
+  /// @param percentile percentile in [0, 100], nearest-rank method is used
+  /// @returns Utilization of each table starting from table 1
+  auto utilization(Date from, Date to, double percentile) const -> std::vector<double>;
+
+private:
+  std::vector<Day> daysData;                    ///< Loaded days
+  std::optional<std::uintmax_t> validSize = {}; ///< Size of the file before the torn block
+};
+
+} // namespace ComputerClub::History
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <charconv>
 #include <optional>
+#include <vector>
 
 namespace {
 auto tryParseTwoDigits(std::string_view str) -> std::optional<std::uint8_t> {
@@ -29,6 +30,14 @@ auto tryParseTime(std::string_view str) -> std::optional<ComputerClub::Time> {
   return ComputerClub::Time{.hour = hour.value(), .minute = minute.value()};
 }
 
+/// Parses time at the start of @p str without checking it's format
+auto parseTrustedTime(std::string_view str) -> ComputerClub::Time {
+  return {
+      .hour = std::uint8_t((str[0] - '0') * 10 + (str[1] - '0')),
+      .minute = std::uint8_t((str[3] - '0') * 10 + (str[4] - '0')),
+  };
+}
+
 auto tryParseNumber(std::string_view str) -> std::optional<std::uint64_t> {
   std::uint64_t result;
   std::from_chars_result parseTablesResult = std::from_chars(str.begin(), str.end(), result);
@@ -39,12 +48,110 @@ auto tryParseNumber(std::string_view str) -> std::optional<std::uint64_t> {
   return result;
 }
 
+auto tryParseNumbers(std::string_view str) -> std::optional<std::vector<std::uint64_t>> {
+  std::vector<std::uint64_t> result;
+  while (true) {
+    auto spacePos = str.find(' ');
+    auto number = tryParseNumber(str.substr(0, spacePos));
+    if (!number.has_value()) {
+      return std::nullopt;
+    }
+    result.push_back(number.value());
+    if (spacePos == std::string_view::npos) {
+      return result;
+    }
+    str = str.substr(spacePos + 1);
+  }
+}
+
+/// Parses the zone number at the start of the @p line of the partitioned club
+/// @returns index of the zone starting from 0 and position of the event in @p line
+auto tryParseZone(std::string_view line, std::size_t zonesAmount)
+    -> std::optional<std::pair<std::size_t, std::size_t>> {
+  auto spacePos = line.find(' ');
+  if (spacePos == std::string_view::npos) {
+    return std::nullopt;
+  }
+  auto zone = tryParseNumber(line.substr(0, spacePos));
+  if (!zone.has_value() || zone.value() == 0 || zone.value() > zonesAmount) {
+    return std::nullopt;
+  }
+  return std::pair{std::size_t(zone.value() - 1), spacePos + 1};
+}
+
 auto validClientName(std::string_view str) -> bool {
   return std::ranges::all_of(str, [](char c) {
     return ((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') || c == '_' || c == '-');
   });
 }
 
+/// Fields of the input event line
+struct EventFields {
+  ComputerClub::Time time;  ///< Time of the event
+  std::uint8_t number;      ///< Number of the event
+  std::string_view client;  ///< Name of the client
+  std::uintmax_t table = 0; ///< Table number, only for event 2
+};
+
+/// Extracts fields of the input event from @p line in one pass
+/// @tparam V Strictness of the validation. Only the length and the event number of the trusted
+///         line are checked.
+/// @returns @c std::nullopt if the event is invalid
+template <ComputerClub::Parser::Validation V>
+auto tryParseEventFields(std::string_view line) -> std::optional<EventFields> {
+  constexpr bool strict = V == ComputerClub::Parser::Validation::Strict;
+
+  if (line.size() < TimeLength + 3 /* space, event number, space */) {
+    return std::nullopt;
+  }
+  EventFields fields{.number = std::uint8_t(line[TimeLength + 1] - '0'),
+                     .client = line.substr(TimeLength + 3)};
+  if constexpr (strict) {
+    if (line[TimeLength] != ' ' || line[TimeLength + 2] != ' ') {
+      return std::nullopt;
+    }
+    auto time = tryParseTime(line.substr(0, TimeLength));
+    if (!time.has_value()) {
+      return std::nullopt;
+    }
+    fields.time = time.value();
+  } else {
+    fields.time = parseTrustedTime(line);
+  }
+
+  switch (fields.number) {
+  case 1:
+  case 3:
+  case 4:
+  case 5:
+    break;
+  case 2: {
+    auto spacePos = fields.client.find(' ');
+    auto tableStr = fields.client.substr(spacePos + 1);
+    fields.client = fields.client.substr(0, spacePos);
+    if constexpr (strict) {
+      auto table = tryParseNumber(tableStr);
+      if (!table.has_value()) {
+        return std::nullopt;
+      }
+      fields.table = table.value();
+    } else {
+      std::from_chars(tableStr.begin(), tableStr.end(), fields.table);
+    }
+    break;
+  }
+  default:
+    return std::nullopt;
+  }
+
+  if constexpr (strict) {
+    if (!validClientName(fields.client)) {
+      return std::nullopt;
+    }
+  }
+  return fields;
+}
+
 } // namespace
 
 namespace ComputerClub::Parser {
@@ -56,7 +163,7 @@ auto parseConfig(std::istream &stream) -> Config {
     throw ParsingError("");
   }
   std::getline(stream, line);
-  auto tablesAmount = tryParseNumber(line);
+  auto tablesAmount = tryParseNumbers(line);
   if (!tablesAmount.has_value()) {
     throw ParsingError(std::move(line));
   }
@@ -79,62 +186,83 @@ auto parseConfig(std::istream &stream) -> Config {
     throw ParsingError("");
   }
   std::getline(stream, line);
-  auto costPerHour = tryParseNumber(line);
-  if (!costPerHour.has_value()) {
+  auto costPerHour = tryParseNumbers(line);
+  if (!costPerHour.has_value() || costPerHour->size() != tablesAmount->size()) {
     throw ParsingError(std::move(line));
   }
-  return {
-      .tablesAmount = tablesAmount.value(),
+
+  Config config{
+      .tablesAmount = tablesAmount->front(),
       .openingTime = openingTime.value(),
       .closingTime = closingTime.value(),
-      .costPerHour = costPerHour.value(),
+      .costPerHour = costPerHour->front(),
   };
+  if (tablesAmount->size() > 1) {
+    config.tablesAmount = 0;
+    for (std::size_t i = 0; i < tablesAmount->size(); i++) {
+      config.zones.push_back({
+          .tablesAmount = (*tablesAmount)[i],
+          .costPerHour = (*costPerHour)[i],
+      });
+      config.tablesAmount += (*tablesAmount)[i];
+    }
+  }
+  return config;
 }
 
-auto parseInputEvent(std::string line) -> InputEvent {
-  if (line.size() < TimeLength + 3 /* space, event number, space */) {
-    throw ParsingError(std::move(line));
+auto checkInputEvent(std::string_view line) -> std::optional<Time> {
+  auto fields = tryParseEventFields<Validation::Strict>(line);
+  return fields.has_value() ? std::optional{fields->time} : std::nullopt;
+}
+
+auto checkZonedInputEvent(std::string_view line, std::size_t zonesAmount) -> std::optional<Time> {
+  auto zone = tryParseZone(line, zonesAmount);
+  if (!zone.has_value()) {
+    return std::nullopt;
   }
-  if (line[TimeLength] != ' ' || line[TimeLength + 2] != ' ') {
+  return checkInputEvent(line.substr(zone->second));
+}
+
+template <Validation V> auto parseInputEvent(std::string line) -> InputEvent {
+  auto fields = tryParseEventFields<V>(line);
+  if (!fields.has_value()) {
     throw ParsingError(std::move(line));
   }
-  auto time = tryParseTime(std::string_view(line).substr(0, TimeLength));
-  if (!time.has_value()) {
+
+  switch (fields->number) {
+  case 1:
+    return ClientArrivalEvent(fields->time, std::string(fields->client));
+  case 2:
+    return ClientSitInputEvent(fields->time, std::string(fields->client), fields->table);
+  case 3:
+    return ClientWaitingEvent(fields->time, std::string(fields->client));
+  case 4:
+    return ClientLeavingInputEvent(fields->time, std::string(fields->client));
+  case 5:
+    return ClientAutoSitInputEvent(fields->time, std::string(fields->client));
+  default:
     throw ParsingError(std::move(line));
   }
+}
 
-  std::uint8_t eventNumber = line[TimeLength + 1] - '0';
-  auto eventBody = std::string_view(line).substr(TimeLength + 3);
-  switch (eventNumber) {
-  case 1: {
-    if (!validClientName(eventBody)) {
-      throw ParsingError(std::move(line));
-    }
-    return ClientArrivalEvent(time.value(), std::string(eventBody));
-  }
-  case 2: {
-    auto spacePos = eventBody.find(' ');
-    auto name = eventBody.substr(0, spacePos);
-    auto table = tryParseNumber(eventBody.substr(spacePos + 1));
-    if (!table.has_value() || !validClientName(name)) {
-      throw ParsingError(std::move(line));
-    }
-    return ClientSitInputEvent(time.value(), std::string(name), table.value());
-  }
-  case 3: {
-    if (!validClientName(eventBody)) {
-      throw ParsingError(std::move(line));
-    }
-    return ClientWaitingEvent(time.value(), std::string(eventBody));
-  }
-  case 4: {
-    if (!validClientName(eventBody)) {
-      throw ParsingError(std::move(line));
-    }
-    return ClientLeavingInputEvent(time.value(), std::string(eventBody));
+template <Validation V>
+auto parseZonedInputEvent(std::string line, std::size_t zonesAmount)
+    -> std::pair<std::size_t, InputEvent> {
+  auto zone = tryParseZone(line, zonesAmount);
+  if (!zone.has_value()) {
+    throw ParsingError(std::move(line));
   }
-  default:
+  try {
+    return {zone->first, parseInputEvent<V>(line.substr(zone->second))};
+  } catch (const ParsingError &) {
     throw ParsingError(std::move(line));
   }
 }
+
+template auto parseInputEvent<Validation::Strict>(std::string line) -> InputEvent;
+template auto parseInputEvent<Validation::Trusted>(std::string line) -> InputEvent;
+template auto parseZonedInputEvent<Validation::Strict>(std::string line, std::size_t zonesAmount)
+    -> std::pair<std::size_t, InputEvent>;
+template auto parseZonedInputEvent<Validation::Trusted>(std::string line, std::size_t zonesAmount)
+    -> std::pair<std::size_t, InputEvent>;
 } // namespace ComputerClub::Parser
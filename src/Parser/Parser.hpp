@@ -3,7 +3,10 @@
 #include "Config.hpp"
 #include "Events.hpp"
 #include <istream>
+#include <optional>
 #include <stdexcept>
+#include <string_view>
+#include <utility>
 
 namespace ComputerClub::Parser {
 
@@ -13,17 +16,49 @@ public:
   ParsingError(const std::string &message) : runtime_error(message) {}
 };
 
+/// Strictness of the input validation
+enum class Validation {
+  Strict,  ///< Input is fully validated.
+  Trusted, ///< Input has already been validated. Only the checks needed to parse it are performed.
+};
+
 /// Parse the configuration of computer club from @p stream.
+/// Amount of tables and cost per hour may be space-separated lists of the same length, then the
+/// club is partitioned into zones with corresponding amount of tables and cost per hour.
 /// @param stream The input stream to read the configuration from.
 /// @returns The parsed configuration.
 /// @throws ParsingError If the configuration is invalid. Message contains the line that caused the
 ///         error.
 auto parseConfig(std::istream &stream) -> Config;
 
+/// Check the input event in @p line without parsing it.
+/// @param line The line to check.
+/// @returns Time of the event, @c std::nullopt if the event is invalid.
+auto checkInputEvent(std::string_view line) -> std::optional<Time>;
+
+/// Check the input event of the partitioned club in @p line without parsing it.
+/// @param line        The line to check, starts with the zone number.
+/// @param zonesAmount Amount of zones in the club.
+/// @returns Time of the event, @c std::nullopt if the zone or the event is invalid.
+auto checkZonedInputEvent(std::string_view line, std::size_t zonesAmount) -> std::optional<Time>;
+
 /// Parse the input event from @p line.
+/// @tparam V Strictness of the validation. Trusted @p line is not checked for invalid client names,
+///           separators and digits.
 /// @param line The line to parse the event from.
 /// @returns The parsed event.
 /// @throws ParsingError If the event is invalid. Message contains the @p line.
-auto parseInputEvent(std::string line) -> InputEvent;
+template <Validation V = Validation::Strict> auto parseInputEvent(std::string line) -> InputEvent;
+
+/// Parse the input event of the partitioned club from @p line. The line consists of the zone
+/// number starting from 1, space and the event.
+/// @tparam V Strictness of the validation of the event, zone is always validated.
+/// @param line        The line to parse the event from.
+/// @param zonesAmount Amount of zones in the club.
+/// @returns Index of the zone starting from 0 and the parsed event.
+/// @throws ParsingError If the zone or the event is invalid. Message contains the @p line.
+template <Validation V = Validation::Strict>
+auto parseZonedInputEvent(std::string line, std::size_t zonesAmount)
+    -> std::pair<std::size_t, InputEvent>;
 
 } // namespace ComputerClub::Parser
@@ -2,42 +2,391 @@
 
 #include "ComputerClub.hpp"
 #include "Parser.hpp"
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
 
-namespace ComputerClub::Simulator {
-auto simulate(std::istream &input, std::ostream &output, std::ostream &err) -> bool {
-  ComputerClub::Config config;
-  try {
-    config = ComputerClub::Parser::parseConfig(input);
-  } catch (const ComputerClub::Parser::ParsingError &e) {
-    err << e.what() << std::endl;
-    return false;
+namespace {
+
+using ComputerClub::Parser::Validation;
+
+auto toMinutes(ComputerClub::Time time) -> std::uint32_t { return time.hour * 60u + time.minute; }
+
+/// Appends per-table results of @p state to @p summary
+auto summarize(const ComputerClub::State &state, ComputerClub::History::Day &summary) -> void {
+  state.forEachTable(
+      [&summary](std::uintmax_t, std::uintmax_t revenue, ComputerClub::Time usedTime) {
+        summary.revenue.push_back(revenue);
+        summary.usedMinutes.push_back(toMinutes(usedTime));
+      });
+}
+
+/// Prints sessions of all zones sorted by client name, start time and zone each on it's own line.
+/// Each line contains client name, table number, start and end time of the session and charge.
+/// @param zones ledger of each zone
+/// @param zoned whether lines start with the zone number
+auto printLedger(std::ostream &stream, std::span<const ComputerClub::Ledger> zones, bool zoned)
+    -> void {
+  std::vector<std::pair<std::size_t, const ComputerClub::Session *>> sorted;
+  for (std::size_t zone = 0; zone < zones.size(); zone++) {
+    for (const auto &session : zones[zone].sessions) {
+      sorted.emplace_back(zone, &session);
+    }
+  }
+  auto name = [zones](const auto &entry) -> const std::string & {
+    return zones[entry.first].clientNames[entry.second->client];
+  };
+  std::ranges::stable_sort(sorted, [&name](const auto &lhs, const auto &rhs) {
+    return std::tie(name(lhs), lhs.second->start, lhs.first) <
+           std::tie(name(rhs), rhs.second->start, rhs.first);
+  });
+
+  for (const auto &entry : sorted) {
+    const auto &[zone, session] = entry;
+    if (zoned) {
+      stream << zone + 1 << ' ';
+    }
+    stream << name(entry) << ' ' << session->table << ' ' << session->start << ' '
+           << session->end << ' ' << session->charge << '\n';
   }
+}
+
+/// Reads, parses and validates events from @p input one by one.
+/// @tparam V Strictness of the validation. Event times are not checked for trusted input.
+/// @param callback called with index of the zone (0 if the club is not partitioned) and the event
+/// @returns @c false on parsing error, writes first encountered incorrect line to @p err.
+template <Validation V, typename F>
+auto forEachEvent(const ComputerClub::Config &config, std::istream &input, std::ostream &err,
+                  F callback) -> bool {
+  using namespace ComputerClub;
 
-  ComputerClub::State state{config};
   Time lastEventTime{0, 0};
+  std::string line;
   while (!input.eof()) {
-    std::string line;
     std::getline(input, line);
     if (input.eof()) {
       break;
     }
     try {
-      InputEvent event = ComputerClub::Parser::parseInputEvent(line);
-      Time eventTime = std::visit([](const auto &event) { return event.time; }, event);
-      if (eventTime < lastEventTime || eventTime > config.closingTime) {
-        err << line << std::endl;
-        return false;
+      auto [zone, event] = config.zones.empty()
+                               ? std::pair{std::size_t{0}, Parser::parseInputEvent<V>(line)}
+                               : Parser::parseZonedInputEvent<V>(line, config.zones.size());
+      if constexpr (V == Validation::Strict) {
+        Time eventTime = std::visit([](const auto &event) { return event.time; }, event);
+        if (eventTime < lastEventTime || eventTime > config.closingTime) {
+          err << line << std::endl;
+          return false;
+        }
+        lastEventTime = eventTime;
       }
-      lastEventTime = eventTime;
-      state.processEvent(std::move(event));
-    } catch (const ComputerClub::Parser::ParsingError &e) {
+      callback(zone, std::move(event));
+    } catch (const Parser::ParsingError &e) {
       err << e.what() << std::endl;
       return false;
     }
   }
+  return true;
+}
+
+/// Amount of events passed to the zone worker at once
+constexpr std::size_t EventBatchSize = 1024;
+
+/// Amount of batches queued for the zone worker after which the reading thread waits
+constexpr std::size_t MaxQueuedBatches = 16;
+
+/// Bounded queue of event batches passed from the reading thread to the zone worker
+class EventQueue {
+public:
+  /// Adds non-empty @p batch to the queue, waits while the queue is full
+  auto push(std::vector<ComputerClub::InputEvent> batch) -> void {
+    {
+      std::unique_lock lock(this->mutex);
+      this->notFull.wait(lock, [this] { return this->batches.size() < MaxQueuedBatches; });
+      this->batches.push_back(std::move(batch));
+    }
+    this->condition.notify_one();
+  }
+
+  /// Marks that no more batches will be added
+  auto close() -> void {
+    {
+      std::lock_guard lock(this->mutex);
+      this->closed = true;
+    }
+    this->condition.notify_one();
+  }
+
+  /// Waits for the next batch
+  /// @returns empty batch if the queue is closed and all batches are taken
+  auto pop() -> std::vector<ComputerClub::InputEvent> {
+    std::unique_lock lock(this->mutex);
+    this->condition.wait(lock, [this] { return !this->batches.empty() || this->closed; });
+    if (this->batches.empty()) {
+      return {};
+    }
+    auto batch = std::move(this->batches.front());
+    this->batches.pop_front();
+    lock.unlock();
+    this->notFull.notify_one();
+    return batch;
+  }
+
+private:
+  std::mutex mutex;                                               ///< Guards the queue
+  std::condition_variable condition;                              ///< Notified on new batches
+  std::condition_variable notFull;                                ///< Notified on taken batches
+  std::deque<std::vector<ComputerClub::InputEvent>> batches = {}; ///< Batches not taken yet
+  bool closed = false;                                            ///< Whether queue is closed
+};
+
+/// Simulation of one zone of the partitioned club
+struct ZoneSimulation {
+  /// @param config     configuration of the zone
+  /// @param zone       number of the zone starting from 1
+  /// @param options    options of the simulation
+  /// @param traceMutex guards the trace shared by all zones
+  ZoneSimulation(ComputerClub::Config config, std::uint32_t zone,
+                 const ComputerClub::Simulator::Options &options, std::mutex &traceMutex)
+      : trace(options.trace != nullptr ? std::make_unique<ComputerClub::Trace::Writer>(
+                                             *options.trace, zone, &traceMutex)
+                                       : nullptr),
+        state(std::move(config), options.report, this->trace.get(),
+              options.ledger != nullptr ? &this->ledger : nullptr) {}
+
+  /// Processes events of the zone from the queue until it is closed and ends the day
+  auto run() -> void {
+    try {
+      for (auto batch = this->queue.pop(); !batch.empty(); batch = this->queue.pop()) {
+        for (auto &event : batch) {
+          this->state.processEvent(std::move(event));
+          this->recorded.push_back(this->state.recordedEvents());
+        }
+      }
+      this->state.endDay();
+    } catch (...) {
+      // Transitions before the failure are kept for debugging
+      if (this->trace != nullptr) {
+        this->trace->flush();
+      }
+      throw;
+    }
+    if (this->trace != nullptr) {
+      this->trace->flush();
+    }
+  }
+
+  std::unique_ptr<ComputerClub::Trace::Writer> trace; ///< Writer of the trace of the zone
+  ComputerClub::Ledger ledger = {};                   ///< Finished sessions of the zone
+  ComputerClub::State state;                          ///< State of the zone
+  EventQueue queue;                                   ///< Events passed to the worker
+  std::vector<ComputerClub::InputEvent> pending = {}; ///< Events not passed to the worker yet
+  std::vector<std::size_t> recorded = {};             ///< Recorded events after each event
+};
+
+/// Simulates the partitioned club. Each zone is simulated in it's own thread, events are read and
+/// validated on the calling thread and passed to the zones in batches. Output is written only after
+/// all events are valid, events of the zones are merged in the input order.
+template <Validation V>
+auto simulateZones(const ComputerClub::Config &config, std::istream &input, std::ostream &output,
+                   std::ostream &err, const ComputerClub::Simulator::Options &options) -> bool {
+  const ComputerClub::Report &report = options.report;
+
+  // Blocks of all zones are written to the trace while simulating
+  std::mutex traceMutex;
+  if (options.trace != nullptr) {
+    ComputerClub::Trace::writeHeader(*options.trace);
+  }
+  std::deque<ZoneSimulation> zones;
+  for (std::size_t i = 0; i < config.zones.size(); i++) {
+    zones.emplace_back(config.zoneConfig(i), std::uint32_t(i + 1), options, traceMutex);
+  }
+
+  // Zone of each event in the input order
+  std::vector<std::size_t> eventZones;
+  bool valid;
+  {
+    std::vector<std::jthread> threads;
+    threads.reserve(zones.size());
+    for (auto &zone : zones) {
+      threads.emplace_back([&zone] { zone.run(); });
+    }
+
+    auto closeQueues = [&zones] {
+      for (auto &zone : zones) {
+        zone.queue.close();
+      }
+    };
+    try {
+      valid = forEachEvent<V>(config, input, err, [&](std::size_t zone, auto event) {
+        ZoneSimulation &simulation = zones[zone];
+        simulation.pending.push_back(std::move(event));
+        if (simulation.pending.size() >= EventBatchSize) {
+          simulation.queue.push(std::exchange(simulation.pending, {}));
+        }
+        eventZones.push_back(zone);
+      });
+    } catch (...) {
+      closeQueues();
+      throw;
+    }
+
+    for (auto &zone : zones) {
+      if (valid && !zone.pending.empty()) {
+        zone.queue.push(std::move(zone.pending));
+      }
+    }
+    closeQueues();
+  }
+  if (!valid) {
+    return false;
+  }
+
+  std::vector<std::string> prefixes;
+  for (std::size_t i = 0; i < zones.size(); i++) {
+    prefixes.push_back(std::to_string(i + 1) + ' ');
+  }
+
+  if (report.openingTime) {
+    output << config.openingTime << '\n';
+  }
+  std::vector<std::size_t> processed(zones.size(), 0);
+  std::vector<std::size_t> printed(zones.size(), 0);
+  for (std::size_t zone : eventZones) {
+    std::size_t recorded = zones[zone].recorded[processed[zone]++];
+    zones[zone].state.printEvents(output, printed[zone], recorded, prefixes[zone]);
+    printed[zone] = recorded;
+  }
+  for (std::size_t zone = 0; zone < zones.size(); zone++) {
+    zones[zone].state.printEvents(output, printed[zone], zones[zone].state.recordedEvents(),
+                                  prefixes[zone]);
+  }
+  if (report.closingTime) {
+    output << config.closingTime << '\n';
+  }
+  if (report.tables) {
+    for (std::size_t zone = 0; zone < zones.size(); zone++) {
+      zones[zone].state.printTables(output, prefixes[zone]);
+    }
+  }
+  if (options.summary != nullptr) {
+    for (const auto &zone : zones) {
+      summarize(zone.state, *options.summary);
+    }
+  }
+  if (options.ledger != nullptr) {
+    std::vector<ComputerClub::Ledger> ledgers;
+    for (auto &zone : zones) {
+      ledgers.push_back(std::move(zone.ledger));
+    }
+    printLedger(*options.ledger, ledgers, true);
+  }
+  return true;
+}
+
+/// Simulates the club that is not partitioned, events are processed while being read
+template <Validation V>
+auto simulateClub(const ComputerClub::Config &config, std::istream &input, std::ostream &output,
+                  std::ostream &err, const ComputerClub::Simulator::Options &options) -> bool {
+  std::optional<ComputerClub::Trace::Writer> trace;
+  if (options.trace != nullptr) {
+    ComputerClub::Trace::writeHeader(*options.trace);
+    trace.emplace(*options.trace);
+  }
+  ComputerClub::Ledger ledger;
+  ComputerClub::State state{config, options.report, trace ? &trace.value() : nullptr,
+                            options.ledger != nullptr ? &ledger : nullptr};
+  bool valid;
+  try {
+    valid = forEachEvent<V>(config, input, err, [&state](std::size_t, auto event) {
+      state.processEvent(std::move(event));
+    });
+  } catch (...) {
+    // Transitions before the failure are kept for debugging
+    if (trace.has_value()) {
+      trace->flush();
+    }
+    throw;
+  }
+  if (!valid) {
+    return false;
+  }
 
   state.endDay();
   state.print(output);
+  if (options.summary != nullptr) {
+    summarize(state, *options.summary);
+  }
+  if (trace.has_value()) {
+    trace->flush();
+  }
+  if (options.ledger != nullptr) {
+    printLedger(*options.ledger, std::span(&ledger, 1), false);
+  }
+  return true;
+}
+
+} // namespace
+
+namespace ComputerClub::Simulator {
+auto simulate(std::istream &input, std::ostream &output, std::ostream &err, const Options &options)
+    -> bool {
+  ComputerClub::Config config;
+  try {
+    config = ComputerClub::Parser::parseConfig(input);
+  } catch (const ComputerClub::Parser::ParsingError &e) {
+    err << e.what() << std::endl;
+    return false;
+  }
+
+  config.seatPolicy = options.seatPolicy;
+  if (options.summary != nullptr) {
+    options.summary->openMinutes = toMinutes(config.closingTime - config.openingTime);
+  }
+
+  auto simulate = config.zones.empty()
+                      ? (options.trustedInput ? simulateClub<Validation::Trusted>
+                                              : simulateClub<Validation::Strict>)
+                      : (options.trustedInput ? simulateZones<Validation::Trusted>
+                                              : simulateZones<Validation::Strict>);
+  return simulate(config, input, output, err, options);
+}
+
+auto validate(std::istream &input, std::ostream &err) -> bool {
+  ComputerClub::Config config;
+  try {
+    config = ComputerClub::Parser::parseConfig(input);
+  } catch (const ComputerClub::Parser::ParsingError &e) {
+    err << e.what() << std::endl;
+    return false;
+  }
+
+  // Lines are only checked, no events are built
+  ComputerClub::Time lastEventTime{0, 0};
+  std::string line;
+  while (!input.eof()) {
+    std::getline(input, line);
+    if (input.eof()) {
+      break;
+    }
+    auto eventTime = config.zones.empty()
+                         ? ComputerClub::Parser::checkInputEvent(line)
+                         : ComputerClub::Parser::checkZonedInputEvent(line, config.zones.size());
+    if (!eventTime.has_value() || eventTime.value() < lastEventTime ||
+        eventTime.value() > config.closingTime) {
+      err << line << std::endl;
+      return false;
+    }
+    lastEventTime = eventTime.value();
+  }
   return true;
 }
 } // namespace ComputerClub::Simulator
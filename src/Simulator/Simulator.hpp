@@ -1,17 +1,59 @@
 #pragma once
 
+#include "Config.hpp"
+#include "History.hpp"
+#include "Report.hpp"
+#include <ostream>
 #include <istream>
 
 namespace ComputerClub::Simulator {
 
+/// Options of the simulation
+struct Options {
+  Report report = {}; ///< Sections and events of the results to write
+
+  /// Whether the input has already been validated, e.g. it was produced by a converter.
+  /// Trusted input is not checked for invalid client names, separators, digits and event times.
+  /// Simulation of invalid trusted input gives unspecified results.
+  bool trustedInput = false;
+
+  /// Policy of choosing a free table for clients that did not name one
+  SeatPolicy seatPolicy = SeatPolicy::LowestNumber;
+
+  /// If not null, filled with minutes the club was open and per-table results of the day. Tables of
+  /// the partitioned club are numbered through all zones. Date of the day is not changed.
+  History::Day *summary = nullptr;
+
+  /// If not null, compact binary trace of state transitions is written to it while simulating, see
+  /// @ref Trace. The trace is written even if the input turns out to be invalid.
+  std::ostream *trace = nullptr;
+
+  /// If not null, sessions of the clients at the tables with their charges are written to it at
+  /// the end of the day, sorted by client name and start time. Sessions of all zones of the
+  /// partitioned club are sorted together, then by zone, and its lines start with the zone number.
+  std::ostream *ledger = nullptr;
+};
+
 /// Simulate the computer club's operation.
-/// @param input  The input stream to read the configuration and events from.
-/// @param output The output stream to write the results to.
-/// @param err    The error stream to write parsing errors to.
+/// If the club is partitioned into zones, each event line starts with the zone number and the
+/// zones are simulated in parallel. Output lines of events and tables then start with the zone
+/// number as well, events of all zones are printed in the input order.
+/// @param input   The input stream to read the configuration and events from.
+/// @param output  The output stream to write the results to.
+/// @param err     The error stream to write parsing errors to.
+/// @param options Options of the simulation.
 /// @returns @c true if the simulation was successful, does not write anything to @p err, writes
 ///          the results to @p output.
 /// @returns @c false on parsing error, writes first encountered incorrect line to @p err. Writes
 ///          nothing to @p output.
-auto simulate(std::istream &input, std::ostream &output, std::ostream &err) -> bool;
+auto simulate(std::istream &input, std::ostream &output, std::ostream &err,
+              const Options &options = {}) -> bool;
+
+/// Validate the configuration and events without simulating the club.
+/// @param input The input stream to read the configuration and events from.
+/// @param err   The error stream to write parsing errors to.
+/// @returns @c true if the input is valid, does not write anything to @p err.
+/// @returns @c false on parsing error, writes first encountered incorrect line to @p err.
+auto validate(std::istream &input, std::ostream &err) -> bool;
 
 } // namespace ComputerClub::Simulator
@@ -0,0 +1,281 @@
+#include "Trace.hpp"
+#include <algorithm>
+#include <iterator>
+#include <set>
+
+namespace {
+
+/// Magic bytes at the start of the trace
+constexpr char Magic[4] = {'C', 'C', 'T', '2'};
+
+/// Size of the buffer after which records are written to the stream
+constexpr std::size_t FlushThreshold = 1 << 16;
+
+/// Sequential reader of the trace records
+class RecordReader {
+public:
+  explicit RecordReader(std::istream &stream) : stream(stream) {}
+
+  /// @returns @c true if the end of the trace is reached
+  auto atEnd() -> bool { return this->stream.peek() == std::istream::traits_type::eof(); }
+
+  /// Reads the value of type @p T in the native byte order
+  template <typename T> auto fixed() -> T {
+    T value;
+    if (!this->stream.read(reinterpret_cast<char *>(&value), sizeof(T))) {
+      throw ComputerClub::Trace::TraceError("Trace is truncated");
+    }
+    return value;
+  }
+
+  auto byte() -> std::uint8_t {
+    auto value = this->stream.get();
+    if (value == std::istream::traits_type::eof()) {
+      throw ComputerClub::Trace::TraceError("Trace is truncated");
+    }
+    return std::uint8_t(value);
+  }
+
+  auto varint() -> std::uintmax_t {
+    std::uintmax_t value = 0;
+    for (unsigned shift = 0; shift < sizeof(value) * 8; shift += 7) {
+      std::uint8_t next = this->byte();
+      value |= std::uintmax_t(next & 0x7f) << shift;
+      if ((next & 0x80) == 0) {
+        return value;
+      }
+    }
+    throw ComputerClub::Trace::TraceError("Trace contains invalid number");
+  }
+
+  auto string() -> std::string {
+    std::string value(this->varint(), '\0');
+    if (!this->stream.read(value.data(), std::streamsize(value.size()))) {
+      throw ComputerClub::Trace::TraceError("Trace is truncated");
+    }
+    return value;
+  }
+
+private:
+  std::istream &stream;
+};
+
+} // namespace
+
+namespace ComputerClub::Trace {
+
+auto writeHeader(std::ostream &stream) -> void { stream.write(Magic, sizeof(Magic)); }
+
+auto writeBlock(std::ostream &stream, std::uint32_t zone, std::string_view records) -> void {
+  auto size = std::uint64_t(records.size());
+  stream.write(reinterpret_cast<const char *>(&zone), sizeof(zone));
+  stream.write(reinterpret_cast<const char *>(&size), sizeof(size));
+  stream.write(records.data(), std::streamsize(records.size()));
+}
+
+auto Writer::begin(Kind kind, Time time) -> void {
+  if (this->buffer.size() >= FlushThreshold) {
+    this->flush();
+  }
+  this->buffer.push_back(char(kind));
+  this->buffer.push_back(char(time.hour));
+  this->buffer.push_back(char(time.minute));
+}
+
+auto Writer::varint(std::uintmax_t value) -> void {
+  while (value >= 0x80) {
+    this->buffer.push_back(char((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  this->buffer.push_back(char(value));
+}
+
+auto Writer::flush() -> void {
+  if (this->buffer.empty()) {
+    return;
+  }
+  std::string_view records(this->buffer.data(), this->buffer.size());
+  // Stream is flushed as well, so blocks are kept if the process is aborted later
+  if (this->mutex != nullptr) {
+    std::lock_guard lock(*this->mutex);
+    writeBlock(this->stream, this->zone, records);
+    this->stream.flush();
+  } else {
+    writeBlock(this->stream, this->zone, records);
+    this->stream.flush();
+  }
+  this->buffer.clear();
+}
+
+auto Writer::arrive(Time time, std::uint32_t client, std::string_view name) -> void {
+  this->begin(Kind::Arrive, time);
+  this->varint(client);
+  this->varint(name.size());
+  this->buffer.insert(this->buffer.end(), name.begin(), name.end());
+}
+
+auto Writer::seat(Time time, std::uint32_t client, std::uintmax_t table) -> void {
+  this->begin(Kind::Seat, time);
+  this->varint(client);
+  this->varint(table);
+}
+
+auto Writer::leave(Time time, std::uint32_t client, std::uintmax_t table) -> void {
+  this->begin(Kind::Leave, time);
+  this->varint(client);
+  this->varint(table);
+}
+
+auto Writer::enqueue(Time time, std::uint32_t client) -> void {
+  this->begin(Kind::Enqueue, time);
+  this->varint(client);
+}
+
+auto Writer::dequeue(Time time, std::uint32_t client) -> void {
+  this->begin(Kind::Dequeue, time);
+  this->varint(client);
+}
+
+auto Writer::revenue(Time time, std::uintmax_t table, std::uintmax_t hoursSpent,
+                     std::uintmax_t amount) -> void {
+  this->begin(Kind::Revenue, time);
+  this->varint(table);
+  this->varint(hoursSpent);
+  this->varint(amount);
+}
+
+auto Writer::depart(Time time, std::uint32_t client) -> void {
+  this->begin(Kind::Depart, time);
+  this->varint(client);
+}
+
+auto Snapshot::replay(std::istream &stream, Time until) -> Snapshot {
+  char magic[sizeof(Magic)];
+  if (!stream.read(magic, sizeof(magic)) ||
+      !std::equal(std::begin(Magic), std::end(Magic), std::begin(magic))) {
+    throw TraceError("Not a trace");
+  }
+
+  auto begin = stream.tellg();
+  stream.seekg(0, std::ios::end);
+  auto end = stream.tellg();
+  stream.seekg(begin);
+
+  Snapshot snapshot;
+  // Zones whose records after @p until are reached, their later blocks are skipped
+  std::set<std::uint32_t> finishedZones;
+  RecordReader reader(stream);
+  while (!reader.atEnd()) {
+    auto zoneNumber = reader.fixed<std::uint32_t>();
+    Zone &zone = snapshot.zones[zoneNumber];
+    auto size = reader.fixed<std::uint64_t>();
+    auto blockEnd = stream.tellg();
+    if (std::uint64_t(end - blockEnd) < size) {
+      throw TraceError("Trace is truncated");
+    }
+    blockEnd += std::streamoff(size);
+    if (finishedZones.contains(zoneNumber)) {
+      stream.seekg(blockEnd);
+      continue;
+    }
+
+    while (stream.tellg() < blockEnd) {
+      auto kind = Kind(reader.byte());
+      Time time{.hour = reader.byte(), .minute = reader.byte()};
+      if (time > until) {
+        finishedZones.insert(zoneNumber);
+        stream.seekg(blockEnd);
+        break;
+      }
+      switch (kind) {
+      case Kind::Arrive: {
+        auto client = std::uint32_t(reader.varint());
+        auto name = reader.string();
+        zone.clients[client] = std::move(name);
+        break;
+      }
+      case Kind::Seat: {
+        auto client = std::uint32_t(reader.varint());
+        auto table = reader.varint();
+        TableData &tableData = zone.tables[table];
+        tableData.client = client;
+        tableData.currentStart = time;
+        break;
+      }
+      case Kind::Leave: {
+        reader.varint();
+        auto table = reader.varint();
+        TableData &tableData = zone.tables[table];
+        tableData.usedTime += time - tableData.currentStart;
+        tableData.client = std::nullopt;
+        break;
+      }
+      case Kind::Enqueue: {
+        auto client = std::uint32_t(reader.varint());
+        zone.queue.push_back(client);
+        break;
+      }
+      case Kind::Dequeue: {
+        auto client = std::uint32_t(reader.varint());
+        std::erase(zone.queue, client);
+        break;
+      }
+      case Kind::Revenue: {
+        auto table = reader.varint();
+        auto hoursSpent = reader.varint();
+        auto amount = reader.varint();
+        TableData &tableData = zone.tables[table];
+        tableData.hoursPaid += hoursSpent;
+        tableData.revenue += amount;
+        break;
+      }
+      case Kind::Depart: {
+        auto client = std::uint32_t(reader.varint());
+        std::erase(zone.queue, client);
+        zone.clients.erase(client);
+        break;
+      }
+      default:
+        throw TraceError("Trace contains unknown record");
+      }
+    }
+    if (stream.tellg() != blockEnd) {
+      throw TraceError("Trace record crosses the block");
+    }
+  }
+  return snapshot;
+}
+
+auto Snapshot::print(std::ostream &stream) const -> void {
+  auto name = [](const Zone &zone, std::uint32_t client) -> std::string_view {
+    auto it = zone.clients.find(client);
+    return it == zone.clients.end() ? std::string_view("?") : std::string_view(it->second);
+  };
+
+  for (const auto &[zoneNumber, zone] : this->zones) {
+    if (zoneNumber != 0) {
+      stream << "zone " << zoneNumber << '\n';
+    }
+    for (const auto &[table, data] : zone.tables) {
+      stream << "table " << table << ' ';
+      if (data.client.has_value()) {
+        stream << name(zone, data.client.value()) << " since " << data.currentStart;
+      } else {
+        stream << "free";
+      }
+      stream << " revenue " << data.revenue << " hours " << data.hoursPaid << " used "
+             << data.usedTime << '\n';
+    }
+    stream << "queue";
+    for (std::uint32_t client : zone.queue) {
+      stream << ' ' << name(zone, client);
+    }
+    stream << "\nclients";
+    for (const auto &[id, client] : zone.clients) {
+      stream << ' ' << client;
+    }
+    stream << '\n';
+  }
+}
+
+} // namespace ComputerClub::Trace
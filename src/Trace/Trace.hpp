@@ -0,0 +1,123 @@
+#pragma once
+
+#include "Time.hpp"
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ComputerClub::Trace {
+
+/// Kind of the state transition recorded in the trace
+enum class Kind : std::uint8_t {
+  Arrive = 1,  ///< Client arrived to the club and got an id
+  Seat = 2,    ///< Client sat at the table
+  Leave = 3,   ///< Client left the table
+  Enqueue = 4, ///< Client started waiting in the queue
+  Dequeue = 5, ///< Client was taken from the queue to be seated
+  Revenue = 6, ///< Table revenue was increased
+  Depart = 7,  ///< Client left the club
+};
+
+/// Exception thrown when the trace can not be read.
+class TraceError final : public std::runtime_error {
+public:
+  TraceError(const std::string &message) : runtime_error(message) {}
+};
+
+/// Writes the header of the trace to @p stream. Should be written once before all blocks.
+auto writeHeader(std::ostream &stream) -> void;
+
+/// Writes the block of @p records of the @p zone to @p stream. The block starts with the zone and
+/// the size of the records, so the reader may skip the rest of the block. Blocks of one zone follow
+/// in time order, blocks of different zones may interleave. Values are stored in the native byte
+/// order.
+/// @param zone zone of the club, 0 if club is not partitioned
+auto writeBlock(std::ostream &stream, std::uint32_t zone, std::string_view records) -> void;
+
+/// Writer of the compact binary trace records of state transitions of one zone of the club.
+/// Each record is the kind, the time and varint-encoded fields. Client names are written only on
+/// arrival, other records refer to the client by id. Records are buffered and written to the
+/// stream as a block each time the buffer fills up, so memory use does not grow with the day.
+class Writer {
+public:
+  /// Creates a new writer
+  /// @param stream stream to write blocks to
+  /// @param zone   zone of the club whose transitions are recorded, 0 if club is not partitioned
+  /// @param mutex  guards @p stream shared by writers of several zones, nullptr if not shared
+  explicit Writer(std::ostream &stream, std::uint32_t zone = 0, std::mutex *mutex = nullptr)
+      : stream(stream), zone(zone), mutex(mutex) {}
+
+  /// Flushes buffered records
+  ~Writer() { this->flush(); }
+
+  Writer(const Writer &) = delete;
+  auto operator=(const Writer &) -> Writer & = delete;
+
+  /// Records state transitions, see @ref Kind
+  auto arrive(Time time, std::uint32_t client, std::string_view name) -> void;
+  auto seat(Time time, std::uint32_t client, std::uintmax_t table) -> void;
+  auto leave(Time time, std::uint32_t client, std::uintmax_t table) -> void;
+  auto enqueue(Time time, std::uint32_t client) -> void;
+  auto dequeue(Time time, std::uint32_t client) -> void;
+  auto revenue(Time time, std::uintmax_t table, std::uintmax_t hoursSpent, std::uintmax_t amount)
+      -> void;
+  auto depart(Time time, std::uint32_t client) -> void;
+
+  /// Writes buffered records to the stream as a block
+  auto flush() -> void;
+
+private:
+  /// Starts a new record
+  auto begin(Kind kind, Time time) -> void;
+
+  /// Appends @p value in LEB128 encoding
+  auto varint(std::uintmax_t value) -> void;
+
+private:
+  std::ostream &stream;          ///< Stream to write blocks to
+  std::uint32_t zone;            ///< Zone of the club
+  std::mutex *mutex;             ///< Guards the stream, nullptr if not shared
+  std::vector<char> buffer = {}; ///< Records that are not written yet
+};
+
+/// State of the club reconstructed from the trace
+class Snapshot {
+public:
+  /// Applies transitions from @p stream that happened not later than @p until. Records of each
+  /// zone are ordered by time, so the rest of the zone is skipped after the first later record.
+  /// @throws TraceError If @p stream is not a valid trace.
+  static auto replay(std::istream &stream, Time until) -> Snapshot;
+
+  /// Prints tables, queue and clients of each zone of the club
+  auto print(std::ostream &stream) const -> void;
+
+private:
+  /// Data of the table
+  struct TableData {
+    std::optional<std::uint32_t> client = std::nullopt; ///< Client sitting at the table
+    Time currentStart = {0, 0};                         ///< Time the client sat at the table
+    std::uintmax_t revenue = 0;                         ///< Total revenue of the table
+    std::uintmax_t hoursPaid = 0;                       ///< Total hours paid at the table
+    Time usedTime = {0, 0};                             ///< Total time spent at the table
+  };
+
+  /// State of one zone of the club
+  struct Zone {
+    std::map<std::uintmax_t, TableData> tables = {};   ///< Tables of the zone
+    std::deque<std::uint32_t> queue = {};              ///< Clients waiting in the queue
+    std::map<std::uint32_t, std::string> clients = {}; ///< Names of clients in the zone by id
+  };
+
+private:
+  std::map<std::uint32_t, Zone> zones = {}; ///< Zones of the club
+};
+
+} // namespace ComputerClub::Trace
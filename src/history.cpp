@@ -0,0 +1,74 @@
+#include "History.hpp"
+#include <charconv>
+#include <iostream>
+#include <string_view>
+
+namespace {
+
+auto usage(const char *program) -> int {
+  std::cerr << "Usage: " << program << " <store> revenue <YYYY-MM>\n"
+            << "       " << program << " <store> utilization <YYYY-MM> <percentile>\n"
+            << "       " << program << " <store> repair" << std::endl;
+  return 1;
+}
+
+} // namespace
+
+auto main(int argc, char *argv[]) -> int {
+  if (argc == 3 && std::string_view(argv[2]) == "repair") {
+    try {
+      if (ComputerClub::History::Store::repair(argv[1])) {
+        std::cerr << "Torn block at the end of " << argv[1] << " is removed" << std::endl;
+      }
+    } catch (const ComputerClub::History::HistoryError &e) {
+      std::cerr << e.what() << std::endl;
+      return 1;
+    }
+    return 0;
+  }
+  if (argc < 4) {
+    return usage(argv[0]);
+  }
+
+  std::string_view query = argv[2];
+  auto month = ComputerClub::History::parseMonth(argv[3]);
+  if (!month.has_value()) {
+    return usage(argv[0]);
+  }
+  auto [from, to] = month.value();
+
+  try {
+    ComputerClub::History::Store store(argv[1]);
+    if (store.tornTail()) {
+      std::cerr << argv[1] << " ends with a torn block, it is ignored" << std::endl;
+    }
+
+    if (query == "revenue" && argc == 4) {
+      auto revenue = store.revenue(from, to);
+      for (std::size_t i = 0; i < revenue.size(); i++) {
+        std::cout << i + 1 << ' ' << revenue[i] << '\n';
+      }
+      return 0;
+    }
+
+    if (query == "utilization" && argc == 5) {
+      std::string_view percentileArg = argv[4];
+      double percentile;
+      auto result = std::from_chars(percentileArg.begin(), percentileArg.end(), percentile);
+      if (result.ptr != percentileArg.end() || result.ec != std::errc{} || percentile < 0 ||
+          percentile > 100) {
+        return usage(argv[0]);
+      }
+      auto utilization = store.utilization(from, to, percentile);
+      for (std::size_t i = 0; i < utilization.size(); i++) {
+        std::cout << i + 1 << ' ' << utilization[i] << '\n';
+      }
+      return 0;
+    }
+  } catch (const ComputerClub::History::HistoryError &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+
+  return usage(argv[0]);
+}
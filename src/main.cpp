@@ -1,18 +1,192 @@
 #include "Simulator.hpp"
+#include <charconv>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+namespace {
+
+/// Calls @p callback for each non-empty comma-separated item of @p list
+template <typename F> auto forEachItem(std::string_view list, F callback) -> bool {
+  while (!list.empty()) {
+    auto commaPos = list.find(',');
+    if (!callback(list.substr(0, commaPos))) {
+      return false;
+    }
+    list = commaPos == std::string_view::npos ? std::string_view{} : list.substr(commaPos + 1);
+  }
+  return true;
+}
+
+/// Selects the report sections listed in @p list. Possible sections are "opening", "events",
+/// "closing" and "tables".
+/// @returns @c false if @p list contains unknown section
+auto parseSections(std::string_view list, ComputerClub::Report &report) -> bool {
+  report.openingTime = report.events = report.closingTime = report.tables = false;
+  return forEachItem(list, [&report](std::string_view section) {
+    if (section == "opening") {
+      report.openingTime = true;
+    } else if (section == "events") {
+      report.events = true;
+    } else if (section == "closing") {
+      report.closingTime = true;
+    } else if (section == "tables") {
+      report.tables = true;
+    } else {
+      return false;
+    }
+    return true;
+  });
+}
+
+/// Selects the event codes listed in @p list
+/// @returns @c false if @p list contains invalid event code
+auto parseEventCodes(std::string_view list, ComputerClub::Report &report) -> bool {
+  report.eventCodes.reset();
+  return forEachItem(list, [&report](std::string_view item) {
+    std::size_t code;
+    auto result = std::from_chars(item.begin(), item.end(), code);
+    if (result.ptr != item.end() || result.ec != std::errc{} ||
+        code > ComputerClub::Report::MaxEventCode) {
+      return false;
+    }
+    report.eventCodes.set(code);
+    return true;
+  });
+}
+
+/// @returns path of the temporary file the output to @p path is written to
+auto temporaryPath(std::string_view path) -> std::string { return std::string(path) + ".tmp"; }
+
+} // namespace
 
 auto main(int argc, char *argv[]) -> int {
-  if (argc != 2) {
-    std::cerr << "Usage: " << argv[0] << " <filename>" << std::endl;
+  ComputerClub::Simulator::Options options;
+  bool validateOnly = false;
+  std::optional<std::string_view> filename;
+  std::optional<std::string_view> historyPath;
+  std::optional<std::string_view> tracePath;
+  std::optional<std::string_view> ledgerPath;
+  ComputerClub::History::Day day;
+
+  for (int i = 1; i < argc; i++) {
+    std::string_view arg = argv[i];
+    bool valid = true;
+    if (arg == "--sections" && i + 1 < argc) {
+      valid = parseSections(argv[++i], options.report);
+    } else if (arg == "--events" && i + 1 < argc) {
+      valid = parseEventCodes(argv[++i], options.report);
+    } else if (arg == "--trusted") {
+      options.trustedInput = true;
+    } else if (arg == "--validate-only") {
+      validateOnly = true;
+    } else if (arg == "--seat-policy" && i + 1 < argc) {
+      std::string_view policy = argv[++i];
+      if (policy == "lowest") {
+        options.seatPolicy = ComputerClub::SeatPolicy::LowestNumber;
+      } else if (policy == "highest") {
+        options.seatPolicy = ComputerClub::SeatPolicy::HighestNumber;
+      } else {
+        valid = false;
+      }
+    } else if (arg == "--trace" && i + 1 < argc) {
+      tracePath = argv[++i];
+    } else if (arg == "--ledger" && i + 1 < argc) {
+      ledgerPath = argv[++i];
+    } else if (arg == "--history" && i + 2 < argc) {
+      historyPath = argv[++i];
+      auto date = ComputerClub::History::parseDate(argv[++i]);
+      valid = date.has_value();
+      day.date = date.value_or(0);
+    } else if (!arg.starts_with("--") && !filename.has_value()) {
+      filename = arg;
+    } else {
+      valid = false;
+    }
+    if (!valid) {
+      filename = std::nullopt;
+      break;
+    }
+  }
+
+  if (validateOnly && options.trustedInput) {
+    filename = std::nullopt;
+  }
+
+  if (!filename.has_value()) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--sections opening,events,closing,tables] [--events <codes>] [--trusted]"
+                 " [--history <store> <YYYY-MM-DD>] [--trace <trace>]"
+                 " [--seat-policy lowest|highest] [--ledger <ledger>] <filename>\n"
+              << "       " << argv[0] << " --validate-only <filename>" << std::endl;
     return 1;
   }
 
-  std::ifstream input(argv[1]);
+  std::ifstream input(filename->data());
   if (!input.is_open()) {
-    std::cerr << "Failed to open file " << argv[1] << std::endl;
+    std::cerr << "Failed to open file " << *filename << std::endl;
     return 1;
   }
 
-  return ComputerClub::Simulator::simulate(input, std::cout, std::cerr) ? 0 : 1;
+  if (validateOnly) {
+    return ComputerClub::Simulator::validate(input, std::cerr) ? 0 : 1;
+  }
+
+  // Outputs are written to temporary files that replace the requested ones only if the input is
+  // valid, so existing files are kept otherwise. If the simulation aborts, the trace written so far
+  // stays in the temporary file.
+  std::ofstream trace;
+  if (tracePath.has_value()) {
+    trace.open(temporaryPath(*tracePath), std::ios::binary);
+    if (!trace.is_open()) {
+      std::cerr << "Failed to open file " << temporaryPath(*tracePath) << std::endl;
+      return 1;
+    }
+    options.trace = &trace;
+  }
+
+  std::ofstream ledger;
+  if (ledgerPath.has_value()) {
+    ledger.open(temporaryPath(*ledgerPath));
+    if (!ledger.is_open()) {
+      std::cerr << "Failed to open file " << temporaryPath(*ledgerPath) << std::endl;
+      return 1;
+    }
+    options.ledger = &ledger;
+  }
+  if (historyPath.has_value()) {
+    options.summary = &day;
+  }
+  bool valid = ComputerClub::Simulator::simulate(input, std::cout, std::cerr, options);
+  trace.close();
+  ledger.close();
+  for (auto path : {tracePath, ledgerPath}) {
+    if (!path.has_value()) {
+      continue;
+    }
+    std::error_code error;
+    if (!valid) {
+      std::filesystem::remove(temporaryPath(*path), error);
+    } else if (std::filesystem::rename(temporaryPath(*path), *path, error); error) {
+      std::cerr << "Failed to write file " << *path << std::endl;
+      valid = false;
+    }
+  }
+  if (!valid) {
+    return 1;
+  }
+  if (!historyPath.has_value()) {
+    return 0;
+  }
+  try {
+    ComputerClub::History::append(*historyPath, day);
+  } catch (const ComputerClub::History::HistoryError &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
 }
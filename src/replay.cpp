@@ -0,0 +1,49 @@
+#include "Trace.hpp"
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+namespace {
+
+/// Parses the time in format "HH:MM" between 00:00 and 23:59
+auto tryParseTime(std::string_view str) -> std::optional<ComputerClub::Time> {
+  if (str.size() != 5 || str[2] != ':') {
+    return std::nullopt;
+  }
+  for (std::size_t i : {0, 1, 3, 4}) {
+    if (str[i] < '0' || str[i] > '9') {
+      return std::nullopt;
+    }
+  }
+  auto hour = (str[0] - '0') * 10 + (str[1] - '0');
+  auto minute = (str[3] - '0') * 10 + (str[4] - '0');
+  if (hour > 23 || minute > 59) {
+    return std::nullopt;
+  }
+  return ComputerClub::Time{std::uint8_t(hour), std::uint8_t(minute)};
+}
+
+} // namespace
+
+auto main(int argc, char *argv[]) -> int {
+  auto until = argc == 3 ? tryParseTime(argv[2]) : std::nullopt;
+  if (!until.has_value()) {
+    std::cerr << "Usage: " << argv[0] << " <trace> <HH:MM>" << std::endl;
+    return 1;
+  }
+
+  std::ifstream input(argv[1], std::ios::binary);
+  if (!input.is_open()) {
+    std::cerr << "Failed to open file " << argv[1] << std::endl;
+    return 1;
+  }
+
+  try {
+    ComputerClub::Trace::Snapshot::replay(input, until.value()).print(std::cout);
+  } catch (const ComputerClub::Trace::TraceError &e) {
+    std::cerr << e.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
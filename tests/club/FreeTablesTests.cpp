@@ -0,0 +1,43 @@
+#include "FreeTables.hpp"
+#include "gtest/gtest.h"
+
+using ComputerClub::FreeTables;
+
+TEST(FreeTablesTest, NoTables) {
+  FreeTables tables(0);
+  EXPECT_FALSE(tables.lowest().has_value());
+  EXPECT_FALSE(tables.highest().has_value());
+}
+
+TEST(FreeTablesTest, LowestAndHighestAcrossLevels) {
+  constexpr std::uint64_t tablesAmount = 64 * 64 * 3 + 5;
+  FreeTables tables(tablesAmount);
+  EXPECT_EQ(tables.lowest(), 1);
+  EXPECT_EQ(tables.highest(), tablesAmount);
+
+  for (std::uintmax_t table = 1; table <= tablesAmount; table++) {
+    tables.occupy(table);
+  }
+  EXPECT_FALSE(tables.lowest().has_value());
+  EXPECT_FALSE(tables.highest().has_value());
+
+  tables.release(9000);
+  tables.release(64);
+  tables.release(4100);
+  EXPECT_EQ(tables.lowest(), 64);
+  EXPECT_EQ(tables.highest(), 9000);
+
+  tables.occupy(64);
+  tables.occupy(9000);
+  EXPECT_EQ(tables.lowest(), 4100);
+  EXPECT_EQ(tables.highest(), 4100);
+}
+
+TEST(FreeTablesTest, OutOfRangeTablesAreIgnored) {
+  FreeTables tables(2);
+  tables.occupy(0);
+  tables.occupy(3);
+  tables.release(100);
+  EXPECT_EQ(tables.lowest(), 1);
+  EXPECT_EQ(tables.highest(), 2);
+}
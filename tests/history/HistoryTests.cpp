@@ -0,0 +1,107 @@
+#include "History.hpp"
+#include "gtest/gtest.h"
+#include <filesystem>
+
+namespace fs = std::filesystem;
+
+using ComputerClub::History::append;
+using ComputerClub::History::Day;
+using ComputerClub::History::HistoryError;
+using ComputerClub::History::Store;
+
+class HistoryTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    path = fs::temp_directory_path() /
+           (::testing::UnitTest::GetInstance()->current_test_info()->name() + std::string(".hist"));
+    fs::remove(path);
+  }
+
+  void TearDown() override { fs::remove(path); }
+
+  fs::path path;
+};
+
+TEST_F(HistoryTest, AppendedDaysAreReloaded) {
+  append(path,
+         {.date = 20240301, .openMinutes = 600, .revenue = {70, 30}, .usedMinutes = {358, 138}});
+  append(path, {.date = 20240302, .openMinutes = 600, .revenue = {10}, .usedMinutes = {60}});
+
+  Store store(path);
+  ASSERT_EQ(store.days().size(), 2);
+  EXPECT_EQ(store.days()[0].date, 20240301);
+  EXPECT_EQ(store.days()[0].revenue, (std::vector<std::uint64_t>{70, 30}));
+  EXPECT_EQ(store.days()[1].usedMinutes, (std::vector<std::uint32_t>{60}));
+}
+
+TEST_F(HistoryTest, MonthlyRevenue) {
+  append(path, {.date = 20240301, .openMinutes = 600, .revenue = {70, 30}, .usedMinutes = {0, 0}});
+  append(path,
+         {.date = 20240315, .openMinutes = 600, .revenue = {10, 5, 1}, .usedMinutes = {0, 0, 0}});
+  append(path, {.date = 20240401, .openMinutes = 600, .revenue = {100}, .usedMinutes = {0}});
+
+  Store store(path);
+
+  auto month = ComputerClub::History::parseMonth("2024-03");
+  ASSERT_TRUE(month.has_value());
+  EXPECT_EQ(store.revenue(month->first, month->second), (std::vector<std::uint64_t>{80, 35, 1}));
+}
+
+TEST_F(HistoryTest, UtilizationPercentile) {
+  append(path, {.date = 20240301, .openMinutes = 100, .revenue = {0}, .usedMinutes = {10}});
+  append(path, {.date = 20240302, .openMinutes = 100, .revenue = {0}, .usedMinutes = {50}});
+  append(path, {.date = 20240303, .openMinutes = 100, .revenue = {0}, .usedMinutes = {90}});
+
+  Store store(path);
+
+  EXPECT_EQ(store.utilization(20240300, 20240399, 50), (std::vector<double>{0.5}));
+  EXPECT_EQ(store.utilization(20240300, 20240399, 100), (std::vector<double>{0.9}));
+}
+
+TEST_F(HistoryTest, TornBlockKeepsEarlierDays) {
+  append(path, {.date = 20240301, .openMinutes = 600, .revenue = {70}, .usedMinutes = {358}});
+  append(path, {.date = 20240302, .openMinutes = 600, .revenue = {10}, .usedMinutes = {60}});
+  fs::resize_file(path, fs::file_size(path) - 4);
+
+  Store torn(path);
+  EXPECT_TRUE(torn.tornTail());
+  ASSERT_EQ(torn.days().size(), 1);
+  EXPECT_EQ(torn.days()[0].revenue, (std::vector<std::uint64_t>{70}));
+
+  Day day{.date = 20240303, .openMinutes = 600, .revenue = {20}, .usedMinutes = {120}};
+  EXPECT_THROW(append(path, day), HistoryError);
+  EXPECT_TRUE(Store::repair(path));
+  append(path, day);
+
+  Store repaired(path);
+  EXPECT_FALSE(repaired.tornTail());
+  ASSERT_EQ(repaired.days().size(), 2);
+  EXPECT_EQ(repaired.days()[1].date, 20240303);
+}
+
+TEST_F(HistoryTest, AppendedAgainDayReplacesEarlierOne) {
+  append(path, {.date = 20240301, .openMinutes = 600, .revenue = {100}, .usedMinutes = {60}});
+  append(path, {.date = 20240302, .openMinutes = 600, .revenue = {10}, .usedMinutes = {60}});
+  append(path, {.date = 20240301, .openMinutes = 600, .revenue = {100}, .usedMinutes = {60}});
+
+  Store store(path);
+  EXPECT_EQ(store.days().size(), 2);
+  EXPECT_EQ(store.revenue(20240300, 20240399), (std::vector<std::uint64_t>{110}));
+}
+
+TEST_F(HistoryTest, MismatchedColumnsAreRejected) {
+  EXPECT_THROW(
+      append(path, {.date = 20240301, .openMinutes = 600, .revenue = {70, 30}, .usedMinutes = {1}}),
+      HistoryError);
+  EXPECT_TRUE(Store(path).days().empty());
+}
+
+TEST(HistoryDateTest, ParseDate) {
+  EXPECT_EQ(ComputerClub::History::parseDate("2024-03-01"), 20240301);
+  EXPECT_FALSE(ComputerClub::History::parseDate("2024-13-01").has_value());
+  EXPECT_FALSE(ComputerClub::History::parseDate("2024-03-1").has_value());
+  EXPECT_EQ(ComputerClub::History::parseDate("2024-02-29"), 20240229);
+  EXPECT_FALSE(ComputerClub::History::parseDate("2023-02-29").has_value());
+  EXPECT_FALSE(ComputerClub::History::parseDate("2024-02-31").has_value());
+  EXPECT_FALSE(ComputerClub::History::parseDate("2024-04-31").has_value());
+}
@@ -1,5 +1,6 @@
 
 #include "Simulator.hpp"
+#include "Trace.hpp"
 #include "gtest/gtest.h"
 #include <filesystem>
 #include <fstream>
@@ -21,6 +22,10 @@ static const char *testCases[] = {
     "ClientTriesToSitAtHisOwnTable",
     "TableUsedAfterClientLeft",
     "ClientsLeaveInAlphabeticOrder",
+    "Zones",
+    "UnknownZone",
+    "AutoSeat",
+    "ClientSitsAtTableOutOfRange",
 };
 
 class IntegrationTest : public ::testing::TestWithParam<const char *> {};
@@ -44,3 +49,227 @@ TEST_P(IntegrationTest, Main) {
   ASSERT_EQ(output.str(), testOutput);
   ASSERT_EQ(err.str(), testErr);
 }
+
+TEST(ReportTest, TablesOnly) {
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / "example.in");
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ComputerClub::Report report{.openingTime = false, .events = false, .closingTime = false};
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.report = report}));
+  ASSERT_EQ(output.str(), "1 70 05:58\n2 30 02:18\n3 90 08:01\n");
+  ASSERT_EQ(err.str(), "");
+}
+
+TEST(ReportTest, ErrorEventsOnly) {
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / "example.in");
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ComputerClub::Report report{.openingTime = false, .closingTime = false, .tables = false};
+  report.eventCodes.reset().set(13);
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.report = report}));
+  ASSERT_EQ(output.str(),
+            "08:48 13 NotOpenYet\n09:52 13 ICanWaitNoLonger!\n11:35 13 PlaceIsBusy\n");
+  ASSERT_EQ(err.str(), "");
+}
+
+TEST_P(IntegrationTest, TrustedInput) {
+  auto testName = GetParam();
+
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / testName += ".in");
+  auto testOutputStream = std::ifstream(fs::path{TEST_DATA_PATH} / testName += ".out");
+
+  std::string testOutput(std::istreambuf_iterator<char>(testOutputStream), {});
+  if (testOutput.empty()) {
+    GTEST_SKIP() << "Trusted input should be valid";
+  }
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.trustedInput = true}));
+  ASSERT_EQ(output.str(), testOutput);
+  ASSERT_EQ(err.str(), "");
+}
+
+TEST_P(IntegrationTest, ValidateOnly) {
+  auto testName = GetParam();
+
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / testName += ".in");
+  auto testOutputStream = std::ifstream(fs::path{TEST_DATA_PATH} / testName += ".out");
+  auto testErrStream = std::ifstream(fs::path{TEST_DATA_PATH} / testName += ".err");
+
+  std::string testOutput(std::istreambuf_iterator<char>(testOutputStream), {});
+  std::string testErr(std::istreambuf_iterator<char>(testErrStream), {});
+
+  std::stringstream err;
+
+  ASSERT_EQ(ComputerClub::Simulator::validate(testInput, err), !testOutput.empty());
+  ASSERT_EQ(err.str(), testErr);
+}
+
+TEST(FreeTableSearchTest, ManyTablesWithoutAutoSeat) {
+  std::stringstream testInput("1000000000000\n09:00 19:00\n10\n"
+                              "09:00 1 a\n09:01 2 a 999999999999\n");
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ComputerClub::Report report{.events = false, .closingTime = false, .tables = false};
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.report = report}));
+  ASSERT_EQ(output.str(), "09:00\n");
+  ASSERT_EQ(err.str(), "");
+}
+
+TEST(FreeTableSearchTest, ManyTablesWithAutoSeat) {
+  std::stringstream testInput("1000000000000\n09:00 19:00\n10\n"
+                              "09:00 1 a\n09:01 1 b\n09:02 2 a 1\n09:03 5 b\n");
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ComputerClub::Report report{.openingTime = false, .closingTime = false, .tables = false};
+  report.eventCodes.reset().set(12);
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.report = report}));
+  ASSERT_EQ(output.str(), "09:03 12 b 2\n");
+
+  testInput.clear();
+  testInput.seekg(0);
+  output.str("");
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(
+      testInput, output, err,
+      {.report = report, .seatPolicy = ComputerClub::SeatPolicy::HighestNumber}));
+  ASSERT_EQ(output.str(), "09:03 12 b 1000000000000\n");
+  ASSERT_EQ(err.str(), "");
+}
+
+TEST(TraceTest, ReplayToTime) {
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / "example.in");
+
+  std::stringstream output;
+  std::stringstream err;
+  std::stringstream trace;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.trace = &trace}));
+
+  std::stringstream noon;
+  ComputerClub::Trace::Snapshot::replay(trace, {12, 40}).print(noon);
+  ASSERT_EQ(noon.str(), "table 1 client4 since 12:33 revenue 30 hours 3 used 02:39\n"
+                        "table 2 client2 since 10:25 revenue 0 hours 0 used 00:00\n"
+                        "table 3 client3 since 10:59 revenue 0 hours 0 used 00:00\n"
+                        "queue\n"
+                        "clients client2 client3 client4\n");
+}
+
+TEST(TraceTest, ReplayInterleavedZoneBlocks) {
+  // Enough records for several blocks of each zone
+  constexpr int clientsAmount = 20000;
+
+  std::stringstream testInput;
+  std::string clients = "clients";
+  testInput << "1 1\n09:00 19:00\n10 20\n";
+  for (int i = 0; i < clientsAmount; i++) {
+    std::string client = "c" + std::to_string(10000 + i);
+    testInput << "1 09:00 1 " << client << "\n2 09:00 1 " << client << '\n';
+    clients += ' ' + client;
+  }
+  testInput << "1 10:00 2 c10000 1\n";
+
+  std::stringstream output;
+  std::stringstream err;
+  std::stringstream trace;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.trace = &trace}));
+
+  std::stringstream snapshot;
+  ComputerClub::Trace::Snapshot::replay(trace, {10, 0}).print(snapshot);
+  ASSERT_EQ(snapshot.str(), "zone 1\n"
+                            "table 1 c10000 since 10:00 revenue 0 hours 0 used 00:00\n"
+                            "queue\n" +
+                                clients + "\nzone 2\nqueue\n" + clients + '\n');
+}
+
+TEST(LedgerTest, SessionsSortedByClient) {
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / "example.in");
+
+  std::stringstream output;
+  std::stringstream err;
+  std::stringstream ledger;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.ledger = &ledger}));
+  ASSERT_EQ(ledger.str(), "client1 1 09:54 12:33 30\n"
+                          "client2 2 10:25 12:43 30\n"
+                          "client3 3 10:59 19:00 90\n"
+                          "client4 1 12:33 15:52 40\n");
+}
+
+TEST(LedgerTest, TableChangeSplitsSession) {
+  auto testInput = std::ifstream(fs::path{TEST_DATA_PATH} / "ClientChangesTable.in");
+
+  std::stringstream output;
+  std::stringstream err;
+  std::stringstream ledger;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.ledger = &ledger}));
+  ASSERT_EQ(ledger.str(), "client1 1 01:20 01:25 7\n"
+                          "client1 2 01:25 02:00 7\n");
+}
+
+TEST(LedgerTest, ZonesAreSortedTogether) {
+  std::stringstream testInput("1 2\n09:00 19:00\n10 20\n"
+                              "1 09:00 1 zed\n2 09:00 1 amy\n1 09:10 2 zed 1\n2 09:20 2 amy 1\n"
+                              "2 10:00 1 zed\n2 10:05 2 zed 2\n");
+
+  std::stringstream output;
+  std::stringstream err;
+  std::stringstream ledger;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(testInput, output, err, {.ledger = &ledger}));
+  ASSERT_EQ(ledger.str(), "2 amy 1 09:20 19:00 200\n"
+                          "1 zed 1 09:10 19:00 100\n"
+                          "2 zed 2 10:05 19:00 180\n");
+}
+
+TEST(ZonesTest, ManyEventsAreStreamedToZones) {
+  // More batches than a zone queue holds, so the reader waits for the workers
+  constexpr int clientsAmount = 40000;
+
+  std::stringstream input;
+  std::string expected = "09:00\n";
+  std::string leaving[2];
+  input << "1 1\n09:00 19:00\n10 20\n";
+  for (int i = 0; i < clientsAmount; i++) {
+    std::string client = "c" + std::to_string(10000 + i);
+    std::string zone = std::to_string(i % 2 + 1);
+    input << zone << " 09:00 1 " << client << '\n';
+    expected += zone + " 09:00 1 " + client + '\n';
+    leaving[i % 2] += zone + " 19:00 11 " + client + '\n';
+  }
+  expected += leaving[0] + leaving[1] + "19:00\n1 1 0 00:00\n2 1 0 00:00\n";
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ASSERT_TRUE(ComputerClub::Simulator::simulate(input, output, err));
+  ASSERT_EQ(output.str(), expected);
+  ASSERT_EQ(err.str(), "");
+}
+
+TEST(ZonesTest, InvalidLineAfterManyEventsSuppressesOutput) {
+  std::stringstream input;
+  input << "1 1\n09:00 19:00\n10 20\n";
+  for (int i = 0; i < 3000; i++) {
+    input << i % 2 + 1 << " 09:00 1 c" << i << '\n';
+  }
+  input << "3 09:00 1 bad\n";
+
+  std::stringstream output;
+  std::stringstream err;
+
+  ASSERT_FALSE(ComputerClub::Simulator::simulate(input, output, err));
+  ASSERT_EQ(output.str(), "");
+  ASSERT_EQ(err.str(), "3 09:00 1 bad\n");
+}